@@ -44,8 +44,7 @@ AboutDialog::AboutDialog(Gtk::Window& parent)
                         "range-v3 https://github.com/ericniebler/range-v3",
                         "safe https://github.com/LouisCharlesC/safe",
                         "spdlog https://github.com/gabime/spdlog",
-                        "stduuid https://github.com/mariusbancila/stduuid",
-                        "ThreadPool https://github.com/adda25/ThreadPool"});
+                        "stduuid https://github.com/mariusbancila/stduuid"});
 
     signal_hide().connect([this]() {
         delete this;
@@ -49,6 +49,17 @@ ActionBar::ActionBar()
     gtk_actionable_set_action_name(GTK_ACTIONABLE(m_buttonMoveRight.gobj()), "win.move-right"); //NOLINT
     moveBox->pack_start(m_buttonMoveRight);
 
+    Glib::RefPtr<Gio::Menu> reorderMenu = Gio::Menu::create();
+    reorderMenu->append(_("Reverse page order"), "win.reverse-pages");
+    reorderMenu->append(_("Sort pages by file"), "win.sort-pages-by-file");
+    m_buttonMovePagesMore.set_image_from_icon_name("pan-up-symbolic");
+    m_buttonMovePagesMore.set_tooltip_text(_("More page reordering operations…"));
+    m_buttonMovePagesMore.get_style_context()->remove_class("image-button");
+    m_buttonMovePagesMore.get_style_context()->add_class("disclosure-button");
+    m_buttonMovePagesMore.get_style_context()->add_class("thin-button");
+    m_buttonMovePagesMore.set_menu_model(reorderMenu);
+    moveBox->pack_start(m_buttonMovePagesMore);
+
     auto removeBox = Gtk::manage(new Gtk::Box{Gtk::ORIENTATION_HORIZONTAL}); // NOLINT
     removeBox->get_style_context()->add_class("linked");
 
@@ -36,6 +36,7 @@ private:
 
     Gtk::Button m_buttonMoveLeft;
     Gtk::Button m_buttonMoveRight;
+    Gtk::MenuButton m_buttonMovePagesMore;
 
     Gtk::Button m_buttonRemovePages;
     Gtk::MenuButton m_buttonRemovePagesMore;
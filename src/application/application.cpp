@@ -16,7 +16,10 @@
 
 #include "application.hpp"
 #include <document.hpp>
+#include <logger.hpp>
+#include <pagerenderer.hpp>
 #include <giomm/menu.h>
+#include <glibmm/main.h>
 #include <glibmm/miscutils.h>
 #include <glibmm/i18n.h>
 #include <config.hpp>
@@ -30,10 +33,33 @@ Glib::RefPtr<Application> Application::create()
 
 Application::Application()
     : Gtk::Application(config::APPLICATION_ID, Gio::APPLICATION_HANDLES_OPEN)
+    , m_thumbnailCache{m_settingsManager.loadThumbnailCacheSize(), createDiskThumbnailCache()}
+    , m_taskRunner{m_settingsManager.loadRenderingThreads()}
 {
     Glib::set_application_name(config::APPLICATION_NAME);
 }
 
+Application::~Application()
+{
+#if GLIB_CHECK_VERSION(2, 64, 0)
+    if (m_memoryMonitor != nullptr) {
+        g_signal_handlers_disconnect_by_data(m_memoryMonitor, this);
+        g_object_unref(m_memoryMonitor);
+    }
+#endif
+}
+
+std::unique_ptr<DiskThumbnailCache> Application::createDiskThumbnailCache()
+{
+    const std::uint64_t diskCacheSize = m_settingsManager.loadDiskCacheSize();
+
+    if (diskCacheSize == 0)
+        return nullptr;
+
+    return std::make_unique<DiskThumbnailCache>(Glib::build_filename(config::getCacheDirPath(), "thumbnails"),
+                                                diskCacheSize);
+}
+
 void Application::addActions()
 {
     m_newWindowAction = add_action("new-window", sigc::mem_fun(*this, &Application::onNewWindowAction));
@@ -46,6 +72,51 @@ void Application::on_startup()
     Gtk::Window::set_default_icon_name(config::APPLICATION_ID);
     addActions();
     addAccels();
+    setupMemoryMonitor();
+}
+
+void Application::setupMemoryMonitor()
+{
+#if GLIB_CHECK_VERSION(2, 64, 0)
+    m_memoryMonitor = g_memory_monitor_dup_default();
+
+    auto onWarning = [](GMemoryMonitor*, GMemoryMonitorWarningLevel level, gpointer application) {
+        static_cast<Application*>(application)->onLowMemory(level >= G_MEMORY_MONITOR_WARNING_LEVEL_CRITICAL);
+    };
+
+    g_signal_connect(m_memoryMonitor,
+                     "low-memory-warning",
+                     G_CALLBACK(static_cast<void (*)(GMemoryMonitor*, GMemoryMonitorWarningLevel, gpointer)>(onWarning)), //NOLINT
+                     this);
+#endif
+}
+
+void Application::onLowMemory(bool isCritical)
+{
+    Logger::logWarning("The system is low on memory, releasing rendering caches");
+
+    // Whatever is on screen survives a low warning
+    if (isCritical)
+        m_thumbnailCache.clear();
+    else
+        m_thumbnailCache.shrink(m_thumbnailCache.usedBytes() / 2);
+
+    for (Gtk::Window* window : get_windows()) {
+        if (auto appWindow = dynamic_cast<AppWindow*>(window); appWindow != nullptr)
+            appWindow->releaseMemory();
+    }
+
+    PageRenderer::releaseDocuments();
+
+    // Speculative renders, and renders of the pages around the visible ones,
+    // whose thumbnails were just dropped, would fill the caches right back up
+    m_taskRunner.setPrefetchPaused(true);
+    m_resumePrefetchConnection.disconnect();
+    m_resumePrefetchConnection = Glib::signal_timeout().connect_seconds([this]() {
+        m_taskRunner.setPrefetchPaused(false);
+        return false;
+    },
+                                                                        prefetchPauseSeconds);
 }
 
 void Application::on_activate()
@@ -103,7 +174,7 @@ void Application::on_open(const Application::type_vec_files& files,
 
 AppWindow* Application::createWindow()
 {
-    auto window = new Slicer::AppWindow{m_taskRunner, m_settingsManager}; //NOLINT
+    auto window = new Slicer::AppWindow{m_taskRunner, m_thumbnailCache, m_settingsManager}; //NOLINT
 
     window->signal_hide().connect([window]() {
         delete window; //NOLINT
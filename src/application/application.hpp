@@ -20,6 +20,7 @@
 #include "appwindow.hpp"
 #include <gtkmm/application.h>
 #include <giomm/simpleaction.h>
+#include <gio/gio.h>
 
 namespace Slicer {
 
@@ -32,20 +33,31 @@ public:
     Application(Application&&) = delete;
     Application& operator=(Application&& src) = delete;
 
-    ~Application() override = default;
+    ~Application() override;
 
 private:
-    TaskRunner m_taskRunner;
     SettingsManager m_settingsManager;
+    // Declared before the task runner, so that it outlives the tasks using it
+    ThumbnailCache m_thumbnailCache;
+    TaskRunner m_taskRunner;
 
     Glib::RefPtr<Gio::SimpleAction> m_newWindowAction;
 
+#if GLIB_CHECK_VERSION(2, 64, 0)
+    GMemoryMonitor* m_memoryMonitor = nullptr;
+#endif
+    sigc::connection m_resumePrefetchConnection;
+    static constexpr unsigned int prefetchPauseSeconds = 60;
+
     Application();
+    std::unique_ptr<DiskThumbnailCache> createDiskThumbnailCache();
     AppWindow* createWindow();
 
     void addActions();
     void addAccels();
     void setupAppMenu();
+    void setupMemoryMonitor();
+    void onLowMemory(bool isCritical);
 
     void on_startup() override;
     void on_activate() override;
@@ -36,13 +36,16 @@ namespace Slicer {
 
 const std::vector<int> AppWindow::zoomLevels = {200, 300, 400, 550, 700};
 
-AppWindow::AppWindow(TaskRunner& taskRunner, SettingsManager& settingsManager)
+AppWindow::AppWindow(TaskRunner& taskRunner,
+                     ThumbnailCache& thumbnailCache,
+                     SettingsManager& settingsManager)
     : m_taskRunner{taskRunner}
     , m_settingsManager{settingsManager}
     , m_windowState{}
     , m_zoomLevel{zoomLevels, *this}
     , m_headerBar{m_zoomLevel.zoomLevelIndex()}
     , m_view{m_taskRunner,
+             thumbnailCache,
              std::bind(&AppWindow::onViewMouseWheelUp, this),
              std::bind(&AppWindow::onViewMouseWheelDown, this)}
 {
@@ -67,6 +70,7 @@ void AppWindow::setDocument(std::unique_ptr<Document> document)
 {
     m_document = std::move(document);
     m_view.setDocument(*m_document, m_zoomLevel.currentLevel());
+    m_view.setSpeculativePageSizes(m_zoomLevel.neighbouringLevels());
     m_view.setShowFileNames(false);
 
     m_stack.set_visible_child("editor");
@@ -78,6 +82,11 @@ void AppWindow::setDocument(std::unique_ptr<Document> document)
     m_zoomLevel.enable();
 }
 
+void AppWindow::releaseMemory()
+{
+    m_view.dropOffscreenThumbnails();
+}
+
 bool AppWindow::on_delete_event(GdkEventAny*)
 {
     if (m_isSavingDocument)
@@ -153,6 +162,8 @@ void AppWindow::addActions()
     m_rotateLeftAction = add_action("rotate-left", sigc::mem_fun(*this, &AppWindow::onRotatePagesLeft));
     m_moveLeftAction = add_action("move-left", sigc::mem_fun(*this, &AppWindow::onMovePagesLeft));
     m_moveRightAction = add_action("move-right", sigc::mem_fun(*this, &AppWindow::onMovePagesRight));
+    m_reversePagesAction = add_action("reverse-pages", sigc::mem_fun(*this, &AppWindow::onReversePages));
+    m_sortPagesByFileAction = add_action("sort-pages-by-file", sigc::mem_fun(*this, &AppWindow::onSortPagesByFile));
     m_selectAllAction = add_action("select-all", sigc::mem_fun(*this, &AppWindow::onSelectAll));
     m_selectOddPagesAction = add_action("select-odd", sigc::mem_fun(*this, &AppWindow::onSelectOddPages));
     m_selectEvenPagesAction = add_action("select-even", sigc::mem_fun(*this, &AppWindow::onSelectEvenPages));
@@ -177,6 +188,8 @@ void AppWindow::addActions()
     m_rotateLeftAction->set_enabled(false);
     m_moveLeftAction->set_enabled(false);
     m_moveRightAction->set_enabled(false);
+    m_reversePagesAction->set_enabled(false);
+    m_sortPagesByFileAction->set_enabled(false);
     m_selectAllAction->set_enabled(false);
     m_invertSelectionAction->set_enabled(false);
     m_cancelSelectionAction->set_enabled(false);
@@ -187,6 +200,8 @@ void AppWindow::setupWidgets()
     set_titlebar(m_headerBar);
 
     m_scroller.add(m_view);
+    m_view.setVerticalAdjustment(m_scroller.get_vadjustment());
+    m_view.setPrefetchMargin(m_settingsManager.loadPrefetchMargin());
     auto editorBox = Gtk::manage(new Gtk::Box{Gtk::ORIENTATION_VERTICAL}); // NOLINT
     editorBox->pack_start(m_scroller);
     editorBox->pack_start(m_actionBar, Gtk::PACK_SHRINK);
@@ -247,6 +262,11 @@ void AppWindow::loadCustomCSS()
             padding-left: 4px;
             padding-right: 4px;
         }
+
+        .page-widget:selected {
+            background-color: @theme_selected_bg_color;
+            border-radius: 3px;
+        }
     )");
     Gtk::StyleContext::add_provider_for_screen(screen,
                                                provider,
@@ -388,7 +408,7 @@ void AppWindow::tryAddDocumentsAt(const std::vector<Glib::RefPtr<Gio::File>>& fi
                                                             position,
                                                             m_headerBar,
                                                             m_view);
-        m_commandManager.execute(command);
+        executeCommand(command);
     }
     catch (...) {
         Logger::logError("The files couldn't be added");
@@ -446,33 +466,40 @@ void AppWindow::tryOpenDocument(const Glib::RefPtr<Gio::File>& file)
     }
 }
 
+void AppWindow::executeCommand(const std::shared_ptr<Command>& command)
+{
+    View::SelectionBatch selectionBatch{m_view};
+    m_commandManager.execute(command);
+}
+
 void AppWindow::onUndoAction()
 {
+    View::SelectionBatch selectionBatch{m_view};
     m_commandManager.undo();
 }
 
 void AppWindow::onRedoAction()
 {
-
+    View::SelectionBatch selectionBatch{m_view};
     m_commandManager.redo();
 }
 
 void AppWindow::onRemoveSelectedPages()
 {
     auto command = std::make_shared<RemovePagesCommand>(*m_document, m_view.getSelectedChildrenIndexes());
-    m_commandManager.execute(command);
+    executeCommand(command);
 }
 
 void AppWindow::onRemoveUnselectedPages()
 {
     auto command = std::make_shared<RemovePagesCommand>(*m_document, m_view.getUnselectedChildrenIndexes());
-    m_commandManager.execute(command);
+    executeCommand(command);
 }
 
 void AppWindow::onRemovePreviousPages()
 {
     auto command = std::make_shared<RemovePageRangeCommand>(*m_document, 0, m_view.getSelectedChildIndex() - 1);
-    m_commandManager.execute(command);
+    executeCommand(command);
 }
 
 void AppWindow::onRemoveNextPages()
@@ -480,19 +507,19 @@ void AppWindow::onRemoveNextPages()
     auto command = std::make_shared<RemovePageRangeCommand>(*m_document,
                                                             m_view.getSelectedChildIndex() + 1,
                                                             m_document->numberOfPages() - 1);
-    m_commandManager.execute(command);
+    executeCommand(command);
 }
 
 void AppWindow::onRotatePagesRight()
 {
     auto command = std::make_shared<RotatePagesRightCommand>(*m_document, m_view.getSelectedChildrenIndexes());
-    m_commandManager.execute(command);
+    executeCommand(command);
 }
 
 void AppWindow::onRotatePagesLeft()
 {
     auto command = std::make_shared<RotatePagesLeftCommand>(*m_document, m_view.getSelectedChildrenIndexes());
-    m_commandManager.execute(command);
+    executeCommand(command);
 }
 
 void AppWindow::onMovePagesLeft()
@@ -511,7 +538,7 @@ void AppWindow::onMovePagesLeft()
                                                          indexToMove.back(),
                                                          indexToMove.front() - 1);
 
-    m_commandManager.execute(command);
+    executeCommand(command);
 }
 
 void AppWindow::onMovePagesRight()
@@ -530,7 +557,19 @@ void AppWindow::onMovePagesRight()
                                                          indexToMove.back(),
                                                          indexToMove.front() + 1);
 
-    m_commandManager.execute(command);
+    executeCommand(command);
+}
+
+void AppWindow::onReversePages()
+{
+    auto command = std::make_shared<ReversePagesCommand>(*m_document);
+    executeCommand(command);
+}
+
+void AppWindow::onSortPagesByFile()
+{
+    auto command = std::make_shared<SortPagesBySourceCommand>(*m_document);
+    executeCommand(command);
 }
 
 void AppWindow::onSelectAll()
@@ -558,19 +597,10 @@ void AppWindow::onCancelSelection()
     m_view.clearSelection();
 }
 
-bool isVectorContigous(const std::vector<unsigned int>& vector)
-{
-    for (unsigned int i = 0; i < vector.size(); ++i)
-        if (vector.front() + i != vector.at(i))
-            return false;
-
-    return true;
-}
-
 void AppWindow::onSelectedPagesChanged()
 {
-    const std::vector<unsigned int> indexSelected = m_view.getSelectedChildrenIndexes();
-    const unsigned long numSelected = indexSelected.size();
+    const PageSelection& selection = m_view.selection();
+    const unsigned long numSelected = selection.count();
     const unsigned long numPages = m_document->numberOfPages();
 
     const bool isOddPagesActionEnabled = numPages > 0;
@@ -578,6 +608,10 @@ void AppWindow::onSelectedPagesChanged()
     m_selectOddPagesAction->set_enabled(isOddPagesActionEnabled);
     m_selectEvenPagesAction->set_enabled(isEvenPagesActionEnabled);
 
+    const bool isReorderingEnabled = numPages > 1;
+    m_reversePagesAction->set_enabled(isReorderingEnabled);
+    m_sortPagesByFileAction->set_enabled(isReorderingEnabled);
+
     if (numSelected == 0) {
         m_removeSelectedAction->set_enabled(false);
         m_removeUnselectedAction->set_enabled(false);
@@ -602,24 +636,24 @@ void AppWindow::onSelectedPagesChanged()
         else
             m_removeUnselectedAction->set_enabled();
 
-        if (indexSelected.front() == 0)
+        if (selection.first() == 0)
             m_moveLeftAction->set_enabled(false);
         else
             m_moveLeftAction->set_enabled();
 
-        if (indexSelected.back() == numPages - 1)
+        if (selection.last() == numPages - 1)
             m_moveRightAction->set_enabled(false);
         else
             m_moveRightAction->set_enabled();
     }
 
     if (numSelected == 1) {
-        if (indexSelected.front() == 0)
+        if (selection.first() == 0)
             m_removePreviousAction->set_enabled(false);
         else
             m_removePreviousAction->set_enabled();
 
-        if (indexSelected.front() == numPages - 1)
+        if (selection.first() == numPages - 1)
             m_removeNextAction->set_enabled(false);
         else
             m_removeNextAction->set_enabled();
@@ -634,7 +668,7 @@ void AppWindow::onSelectedPagesChanged()
         m_removePreviousAction->set_enabled(false);
         m_removeNextAction->set_enabled(false);
 
-        if (!isVectorContigous(indexSelected)) {
+        if (!selection.isContiguous()) {
             m_moveLeftAction->set_enabled(false);
             m_moveRightAction->set_enabled(false);
         }
@@ -671,6 +705,7 @@ void AppWindow::onCommandExecuted()
 void AppWindow::onZoomLevelChanged()
 {
     m_view.changePageSize(m_zoomLevel.currentLevel());
+    m_view.setSpeculativePageSizes(m_zoomLevel.neighbouringLevels());
 
     queueRestoreScrollPosition();
 }
@@ -41,6 +41,7 @@ namespace Slicer {
 class AppWindow : public Gtk::ApplicationWindow {
 public:
     AppWindow(TaskRunner& taskRunner,
+              ThumbnailCache& thumbnailCache,
               SettingsManager& settingsManager);
 
     AppWindow(const AppWindow&) = delete;
@@ -51,6 +52,7 @@ public:
     ~AppWindow() override;
 
     void setDocument(std::unique_ptr<Document> document);
+    void releaseMemory();
 
 protected:
     bool on_delete_event(GdkEventAny*) override;
@@ -106,6 +108,8 @@ private:
     Glib::RefPtr<Gio::SimpleAction> m_rotateLeftAction;
     Glib::RefPtr<Gio::SimpleAction> m_moveLeftAction;
     Glib::RefPtr<Gio::SimpleAction> m_moveRightAction;
+    Glib::RefPtr<Gio::SimpleAction> m_reversePagesAction;
+    Glib::RefPtr<Gio::SimpleAction> m_sortPagesByFileAction;
     Glib::RefPtr<Gio::SimpleAction> m_selectAllAction;
     Glib::RefPtr<Gio::SimpleAction> m_selectOddPagesAction;
     Glib::RefPtr<Gio::SimpleAction> m_selectEvenPagesAction;
@@ -134,6 +138,8 @@ private:
     void saveScrollPosition();
     void restoreScrollPosition();
     void queueRestoreScrollPosition();
+    // Applies the selection changes of the command at once
+    void executeCommand(const std::shared_ptr<Command>& command);
 
     // Callbacks
     void onOpenAction();
@@ -151,6 +157,8 @@ private:
     void onRotatePagesLeft();
     void onMovePagesLeft();
     void onMovePagesRight();
+    void onReversePages();
+    void onSortPagesByFile();
     void onSelectAll();
     void onSelectOddPages();
     void onSelectEvenPages();
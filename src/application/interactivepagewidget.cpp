@@ -32,6 +32,26 @@ InteractivePageWidget::InteractivePageWidget(const Glib::RefPtr<const Page>& pag
     setupSignalHandlers();
 }
 
+void InteractivePageWidget::bind(const Glib::RefPtr<const Page>& page, unsigned int position)
+{
+    m_position = position;
+
+    if (page == this->page())
+        return;
+
+    m_pageWidget.setPage(page);
+    setupLabels();
+}
+
+int InteractivePageWidget::labelsHeight()
+{
+    int minimumHeight = 0;
+    int naturalHeight = 0;
+    m_pageLabelBox.get_preferred_height(minimumHeight, naturalHeight);
+
+    return naturalHeight;
+}
+
 void InteractivePageWidget::setSelected(bool selected)
 {
     if (m_isSelected != selected) {
@@ -50,11 +70,46 @@ void InteractivePageWidget::setRenderingTask(const std::weak_ptr<Task>& task)
     m_pageWidget.setRenderingTask(task);
 }
 
+void InteractivePageWidget::setDraftTask(const std::weak_ptr<Task>& task)
+{
+    m_pageWidget.setDraftTask(task);
+}
+
 void InteractivePageWidget::cancelRendering()
 {
     m_pageWidget.cancelRendering();
 }
 
+void InteractivePageWidget::cancelDraft()
+{
+    m_pageWidget.cancelDraft();
+}
+
+std::shared_ptr<Task> InteractivePageWidget::renderingTask() const
+{
+    return m_pageWidget.renderingTask();
+}
+
+bool InteractivePageWidget::needsRendering() const
+{
+    return m_pageWidget.needsRendering();
+}
+
+bool InteractivePageWidget::needsDraft() const
+{
+    return m_pageWidget.needsDraft();
+}
+
+Glib::RefPtr<Gdk::Pixbuf> InteractivePageWidget::thumbnail() const
+{
+    return m_pageWidget.thumbnail();
+}
+
+int InteractivePageWidget::thumbnailRotation() const
+{
+    return m_pageWidget.thumbnailRotation();
+}
+
 void InteractivePageWidget::setShowFilename(bool showFileName)
 {
     if (m_showFileName == showFileName)
@@ -68,20 +123,24 @@ void InteractivePageWidget::setShowFilename(bool showFileName)
         m_pageLabelBox.remove(m_fileNameLabel);
 }
 
-int InteractivePageWidget::sortFunction(const InteractivePageWidget& a,
-                                        const InteractivePageWidget& b)
+void InteractivePageWidget::changeSize(int targetSize)
 {
-    return Page::sortFunction(a.page(), b.page());
+    m_pageWidget.changeSize(targetSize);
 }
 
-void InteractivePageWidget::changeSize(int targetSize)
+void InteractivePageWidget::setThumbnail(const Glib::RefPtr<Gdk::Pixbuf>& thumbnail)
 {
-    m_pageWidget.changeSize(targetSize);
+    m_pageWidget.setThumbnail(thumbnail);
+}
+
+void InteractivePageWidget::setDraftThumbnail(const Glib::RefPtr<Gdk::Pixbuf>& thumbnail)
+{
+    m_pageWidget.setDraftThumbnail(thumbnail);
 }
 
-void InteractivePageWidget::renderPage()
+void InteractivePageWidget::dropThumbnail()
 {
-    m_pageWidget.renderPage();
+    m_pageWidget.dropThumbnail();
 }
 
 void InteractivePageWidget::showSpinner()
@@ -115,13 +174,10 @@ void InteractivePageWidget::setupWidgets()
     m_overlay.add_overlay(m_previewButtonRevealer);
     m_overlay.add(m_pageWidget);
 
-    m_fileNameLabel.set_label(page()->fileName());
-    m_fileNameLabel.set_tooltip_text(page()->fileName());
+    setupLabels();
     m_fileNameLabel.set_ellipsize(Pango::ELLIPSIZE_END);
     m_fileNameLabel.set_max_width_chars(10);
     m_fileNameLabel.set_visible();
-    m_pageNumberLabel.set_label(fmt::format(_("Page {pageNumber}"),
-                                            "pageNumber"_a = page()->indexInFile() + 1)); //NOLINT
     m_pageLabelBox.set_orientation(Gtk::ORIENTATION_VERTICAL);
     m_pageLabelBox.set_margin_top(5);
     m_pageLabelBox.pack_end(m_pageNumberLabel);
@@ -136,10 +192,20 @@ void InteractivePageWidget::setupWidgets()
 
     set_margin_start(10);
     set_margin_end(10);
+    set_can_focus();
+    get_style_context()->add_class("page-widget");
 
     show_all();
 }
 
+void InteractivePageWidget::setupLabels()
+{
+    m_fileNameLabel.set_label(page()->fileName());
+    m_fileNameLabel.set_tooltip_text(page()->fileName());
+    m_pageNumberLabel.set_label(fmt::format(_("Page {pageNumber}"),
+                                            "pageNumber"_a = page()->indexInFile() + 1)); //NOLINT
+}
+
 void InteractivePageWidget::setupSignalHandlers()
 {
     add_events(Gdk::KEY_RELEASE_MASK);
@@ -20,14 +20,13 @@
 #include "pagewidget.hpp"
 #include <gtkmm/button.h>
 #include <gtkmm/eventbox.h>
-#include <gtkmm/flowboxchild.h>
 #include <gtkmm/label.h>
 #include <gtkmm/overlay.h>
 #include <gtkmm/revealer.h>
 
 namespace Slicer {
 
-class InteractivePageWidget : public Gtk::FlowBoxChild {
+class InteractivePageWidget : public Gtk::EventBox {
 
 public:
     InteractivePageWidget(const Glib::RefPtr<const Page>& page,
@@ -41,27 +40,42 @@ public:
 
     ~InteractivePageWidget() override = default;
 
+    // Widgets are recycled while scrolling, so they get bound to the page at each position
+    void bind(const Glib::RefPtr<const Page>& page, unsigned int position);
+    unsigned int position() const { return m_position; }
+    // Height of the labels below the page, which is the same for every page
+    int labelsHeight();
+
     void setSelected(bool selected);
     bool getSelected() const { return m_isSelected; }
 
     void setShowFilename(bool showFileName);
 
+    const Glib::RefPtr<const Page>& page() const;
+
     sigc::signal<void, InteractivePageWidget*> selectedChanged;
     sigc::signal<void, InteractivePageWidget*> shiftSelected;
     sigc::signal<void, Glib::RefPtr<const Page>> previewRequested;
 
-    static int sortFunction(const InteractivePageWidget& a,
-                            const InteractivePageWidget& b);
-
     // Interface of Slicer::PageWidget
     void changeSize(int targetSize);
-    void renderPage();
+    void setThumbnail(const Glib::RefPtr<Gdk::Pixbuf>& thumbnail);
+    void setDraftThumbnail(const Glib::RefPtr<Gdk::Pixbuf>& thumbnail);
+    void dropThumbnail();
     void showSpinner();
     void showPage();
     void setRenderingTask(const std::weak_ptr<Task>& task);
+    void setDraftTask(const std::weak_ptr<Task>& task);
     void cancelRendering();
+    void cancelDraft();
+    std::shared_ptr<Task> renderingTask() const;
+    bool needsRendering() const;
+    bool needsDraft() const;
+    Glib::RefPtr<Gdk::Pixbuf> thumbnail() const;
+    int thumbnailRotation() const;
 
 private:
+    unsigned int m_position = 0;
     bool m_isSelected = false;
     bool m_showFileName = false;
 
@@ -77,8 +91,8 @@ private:
     Gtk::Label m_fileNameLabel;
     Gtk::Label m_pageNumberLabel;
 
-    const Glib::RefPtr<const Page>& page() const;
     void setupWidgets();
+    void setupLabels();
     void setupSignalHandlers();
 };
 
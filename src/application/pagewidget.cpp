@@ -15,7 +15,6 @@
 // along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "pagewidget.hpp"
-#include <pagerenderer.hpp>
 
 namespace Slicer {
 
@@ -27,9 +26,22 @@ PageWidget::PageWidget(const Glib::RefPtr<const Page>& page,
     setupWidgets();
 }
 
+void PageWidget::setPage(const Glib::RefPtr<const Page>& page)
+{
+    if (page == m_page)
+        return;
+
+    dropThumbnail();
+    m_page = page;
+
+    const Page::Size pageSize = m_page->scaledRotatedSize(m_targetSize);
+    set_size_request(pageSize.width, pageSize.height);
+}
+
 void PageWidget::changeSize(int targetSize)
 {
     m_targetSize = targetSize;
+    m_needsRendering = true;
 
     const Page::Size pageSize = m_page->scaledRotatedSize(m_targetSize);
     set_size_request(pageSize.width, pageSize.height);
@@ -53,9 +65,24 @@ void PageWidget::setupWidgets()
     show_all();
 }
 
-void PageWidget::renderPage()
+void PageWidget::setThumbnail(const Glib::RefPtr<Gdk::Pixbuf>& thumbnail)
 {
-    m_thumbnail.set(PageRenderer{m_page}.render(m_targetSize));
+    m_thumbnail.set(thumbnail);
+    m_thumbnailRotation = m_page->currentRotation();
+    m_needsRendering = false;
+}
+
+void PageWidget::setDraftThumbnail(const Glib::RefPtr<Gdk::Pixbuf>& thumbnail)
+{
+    m_thumbnail.set(thumbnail);
+}
+
+void PageWidget::dropThumbnail()
+{
+    cancelRendering();
+    showSpinner();
+    m_thumbnail.clear();
+    m_needsRendering = true;
 }
 
 void PageWidget::showSpinner()
@@ -82,10 +109,47 @@ void PageWidget::setRenderingTask(const std::weak_ptr<Task>& task)
     m_renderingTask = task;
 }
 
+void PageWidget::setDraftTask(const std::weak_ptr<Task>& task)
+{
+    m_draftTask = task;
+}
+
 void PageWidget::cancelRendering()
 {
     if (auto task = m_renderingTask.lock(); task != nullptr)
         task->cancel();
+
+    cancelDraft();
+}
+
+void PageWidget::cancelDraft()
+{
+    if (auto task = m_draftTask.lock(); task != nullptr)
+        task->cancel();
+}
+
+std::shared_ptr<Task> PageWidget::renderingTask() const
+{
+    return m_renderingTask.lock();
+}
+
+bool PageWidget::needsDraft() const
+{
+    // Only pages that show nothing but a spinner get a draft
+    if (!m_needsRendering || isThumbnailVisible())
+        return false;
+
+    auto task = m_draftTask.lock();
+
+    return task == nullptr || task->isCanceled();
+}
+
+Glib::RefPtr<Gdk::Pixbuf> PageWidget::thumbnail() const
+{
+    if (!isThumbnailVisible())
+        return {};
+
+    return m_thumbnail.get_pixbuf();
 }
 
 const Glib::RefPtr<const Page>& PageWidget::page() const
@@ -93,7 +157,7 @@ const Glib::RefPtr<const Page>& PageWidget::page() const
     return m_page;
 }
 
-bool PageWidget::isThumbnailVisible()
+bool PageWidget::isThumbnailVisible() const
 {
     return m_thumbnail.get_parent() != nullptr;
 }
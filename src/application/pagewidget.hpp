@@ -37,12 +37,25 @@ public:
 
     ~PageWidget() override = default;
 
+    // Shows another page, as when the widget is recycled for a different position
+    void setPage(const Glib::RefPtr<const Page>& page);
     void changeSize(int targetSize);
-    void renderPage();
+    void setThumbnail(const Glib::RefPtr<Gdk::Pixbuf>& thumbnail);
+    // Shown until the final thumbnail arrives, so the page still needs rendering
+    void setDraftThumbnail(const Glib::RefPtr<Gdk::Pixbuf>& thumbnail);
+    // Frees the thumbnail and goes back to the spinner, keeping the size of the page
+    void dropThumbnail();
     void showSpinner();
     void showPage();
     void setRenderingTask(const std::weak_ptr<Task>& task);
+    void setDraftTask(const std::weak_ptr<Task>& task);
     void cancelRendering();
+    void cancelDraft();
+    std::shared_ptr<Task> renderingTask() const;
+    bool needsRendering() const { return m_needsRendering; }
+    bool needsDraft() const;
+    Glib::RefPtr<Gdk::Pixbuf> thumbnail() const;
+    int thumbnailRotation() const { return m_thumbnailRotation; }
 
     const Glib::RefPtr<const Page>& page() const;
 
@@ -50,12 +63,15 @@ private:
     Glib::RefPtr<const Page> m_page;
     int m_targetSize;
     std::weak_ptr<Task> m_renderingTask;
+    std::weak_ptr<Task> m_draftTask;
+    bool m_needsRendering = true;
+    int m_thumbnailRotation = 0; // Page rotation the current thumbnail was rendered with
 
     Gtk::Spinner m_spinner;
     Gtk::Image m_thumbnail;
 
     void setupWidgets();
-    bool isThumbnailVisible();
+    bool isThumbnailVisible() const;
 };
 
 } // namespace Slicer
@@ -30,9 +30,8 @@ PreviewWindow::PreviewWindow(const Glib::RefPtr<const Page>& page, TaskRunner& t
     , m_taskRunner{taskRunner}
     , m_actionGroup{Gio::SimpleActionGroup::create()}
     , m_zoomLevel{zoomLevels, *(m_actionGroup.operator->())}
+    , m_pageWidget{m_page, m_zoomLevel.currentLevel(), m_taskRunner}
 {
-    m_pageWidget = std::make_shared<PageWidget>(m_page, m_zoomLevel.currentLevel());
-
 	set_size_request(400, 400);
 	set_default_size(900, 600);
 
@@ -42,16 +41,10 @@ PreviewWindow::PreviewWindow(const Glib::RefPtr<const Page>& page, TaskRunner& t
 	setupWidgets();
 	setupSignalHandlers();
 	loadCustomCSS();
-	renderPage();
 
     show_all_children();
 }
 
-PreviewWindow::~PreviewWindow()
-{
-    m_pageWidget->cancelRendering();
-}
-
 void PreviewWindow::setTitle()
 {
     set_title(fmt::format(_("Page {pageNumber}"),
@@ -82,7 +75,7 @@ void PreviewWindow::setupWidgets()
 	m_boxZoom.set_margin_bottom(15);
 	m_boxZoom.set_margin_right(15);
 
-    m_eventBox.add(*m_pageWidget);
+    m_eventBox.add(m_pageWidget);
     m_scroller.add(m_eventBox);
 	m_overlay.add(m_scroller);
 	m_overlay.add_overlay(m_boxZoom);
@@ -112,10 +105,17 @@ void PreviewWindow::setupSignalHandlers()
     m_zoomLevel.enable();
 
     m_zoomLevel.zoomLevelIndex().signal_changed().connect([this]() {
-        m_pageWidget->cancelRendering();
-        m_pageWidget->changeSize(m_zoomLevel.currentLevel());
-        m_pageWidget->showSpinner();
-        renderPage();
+        m_pageWidget.changeSize(m_zoomLevel.currentLevel());
+        updateVisibleArea();
+    });
+
+    m_scroller.get_hadjustment()->signal_value_changed().connect(sigc::mem_fun(*this, &PreviewWindow::updateVisibleArea));
+    m_scroller.get_vadjustment()->signal_value_changed().connect(sigc::mem_fun(*this, &PreviewWindow::updateVisibleArea));
+    m_scroller.signal_size_allocate().connect([this](Gtk::Allocation&) {
+        updateVisibleArea();
+    });
+    m_pageWidget.signal_size_allocate().connect([this](Gtk::Allocation&) {
+        updateVisibleArea();
     });
 
 	signal_hide().connect([this]() {
@@ -137,23 +137,16 @@ void PreviewWindow::loadCustomCSS()
                                                GTK_STYLE_PROVIDER_PRIORITY_APPLICATION);
 }
 
-void PreviewWindow::renderPage()
+void PreviewWindow::updateVisibleArea()
 {
-    std::weak_ptr<PageWidget> weakWidget = m_pageWidget;
-
-    auto funcExecute = [weakWidget]() {
-        if (auto widget = weakWidget.lock(); widget != nullptr)
-            widget->renderPage();
-    };
+    int x = 0;
+    int y = 0;
 
-    auto funcPostExecute = [weakWidget]() {
-        if (auto widget = weakWidget.lock(); widget != nullptr)
-            widget->showPage();
-    };
+    // Not realized yet. The allocation will call us again.
+    if (!m_pageWidget.translate_coordinates(m_scroller, 0, 0, x, y))
+        return;
 
-    auto task = std::make_shared<Task>(funcExecute, funcPostExecute);
-    m_pageWidget->setRenderingTask(task);
-    m_taskRunner.queueFront(task);
+    m_pageWidget.setVisibleArea({-x, -y, m_scroller.get_allocated_width(), m_scroller.get_allocated_height()});
 }
 
 } // namespace Slicer
@@ -18,8 +18,8 @@
 #define PREVIEWWINDOW_HPP
 
 #include <page.hpp>
-#include "pagewidget.hpp"
 #include "taskrunner.hpp"
+#include "tiledpagewidget.hpp"
 #include "zoomlevelwithactions.hpp"
 #include <glibmm/dispatcher.h>
 #include <giomm/simpleactiongroup.h>
@@ -43,7 +43,7 @@ public:
     PreviewWindow(PreviewWindow&&) = delete;
     PreviewWindow& operator=(PreviewWindow&& src) = delete;
 
-    ~PreviewWindow() override;
+    ~PreviewWindow() override = default;
 
 private:
     static void loadCustomCSS();
@@ -57,7 +57,7 @@ private:
     Gtk::Overlay m_overlay;
     Gtk::ScrolledWindow m_scroller;
     Gtk::EventBox m_eventBox;
-    std::shared_ptr<PageWidget> m_pageWidget;
+    TiledPageWidget m_pageWidget;
 	Gtk::Button m_buttonZoomIn;
 	Gtk::Button m_buttonZoomOut;
 	Gtk::Box m_boxZoom;
@@ -65,7 +65,7 @@ private:
     void setTitle();
 	void setupWidgets();
 	void setupSignalHandlers();
-	void renderPage();
+	void updateVisibleArea();
 };
 
 } // namespace Slicer
@@ -44,6 +44,22 @@ namespace misc {
     static const unsigned int defaultZoomLevel = 0;
 }
 
+namespace rendering {
+    static const std::string groupName = "rendering";
+
+    static const struct {
+        std::string threads = "threads";
+        std::string thumbnailCacheSize = "thumbnail-cache-size";
+        std::string diskCacheSize = "disk-cache-size";
+        std::string prefetchMargin = "prefetch-margin";
+    } keys;
+
+    static const unsigned int defaultThreads = 0; // One thread per core
+    static const int defaultThumbnailCacheSize = 256; // In MiB
+    static const int defaultDiskCacheSize = 512; // In MiB, zero disables the cache
+    static const double defaultPrefetchMargin = 1.0; // In screens
+}
+
 SettingsManager::SettingsManager()
 {
     loadConfigFile();
@@ -106,6 +122,63 @@ void SettingsManager::saveZoomLevel(unsigned int zoomLevel)
     }
 }
 
+unsigned int SettingsManager::loadRenderingThreads()
+{
+    try {
+        const int threads = m_keyFile.get_integer(rendering::groupName, rendering::keys.threads);
+
+        return threads > 0 ? static_cast<unsigned>(threads) : rendering::defaultThreads;
+    }
+    catch (const Glib::Error&) {
+        // Most configurations don't set it, so this isn't worth a warning
+        return rendering::defaultThreads;
+    }
+}
+
+std::size_t SettingsManager::loadThumbnailCacheSize()
+{
+    int sizeInMiB = rendering::defaultThumbnailCacheSize;
+
+    try {
+        sizeInMiB = m_keyFile.get_integer(rendering::groupName, rendering::keys.thumbnailCacheSize);
+    }
+    catch (const Glib::Error&) {
+    }
+
+    if (sizeInMiB < 0)
+        sizeInMiB = rendering::defaultThumbnailCacheSize;
+
+    return static_cast<std::size_t>(sizeInMiB) * 1024 * 1024;
+}
+
+std::uint64_t SettingsManager::loadDiskCacheSize()
+{
+    int sizeInMiB = rendering::defaultDiskCacheSize;
+
+    try {
+        sizeInMiB = m_keyFile.get_integer(rendering::groupName, rendering::keys.diskCacheSize);
+    }
+    catch (const Glib::Error&) {
+    }
+
+    if (sizeInMiB < 0)
+        sizeInMiB = rendering::defaultDiskCacheSize;
+
+    return static_cast<std::uint64_t>(sizeInMiB) * 1024 * 1024;
+}
+
+double SettingsManager::loadPrefetchMargin()
+{
+    try {
+        const double margin = m_keyFile.get_double(rendering::groupName, rendering::keys.prefetchMargin);
+
+        return margin >= 0 ? margin : rendering::defaultPrefetchMargin;
+    }
+    catch (const Glib::Error&) {
+        return rendering::defaultPrefetchMargin;
+    }
+}
+
 void SettingsManager::loadConfigFile()
 {
     try {
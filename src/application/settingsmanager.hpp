@@ -18,6 +18,7 @@
 #define SETTINGSMANAGER_HPP
 
 #include <glibmm/keyfile.h>
+#include <cstdint>
 
 namespace Slicer {
 
@@ -44,6 +45,11 @@ public:
     unsigned int loadZoomLevel();
     void saveZoomLevel(unsigned int zoomLevel);
 
+    unsigned int loadRenderingThreads();
+    std::size_t loadThumbnailCacheSize();
+    std::uint64_t loadDiskCacheSize();
+    double loadPrefetchMargin();
+
 private:
     Glib::KeyFile m_keyFile;
 
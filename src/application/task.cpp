@@ -15,6 +15,7 @@
 // along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "task.hpp"
+#include "taskrunner.hpp"
 
 namespace Slicer {
 
@@ -33,6 +34,9 @@ bool Task::isCanceled() const
 void Task::cancel()
 {
     m_isCanceled = true;
+
+    if (TaskRunner* runner = m_runner.exchange(nullptr); runner != nullptr)
+        runner->dropCanceledTask(this);
 }
 
 void Task::execute()
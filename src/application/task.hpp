@@ -22,6 +22,8 @@
 
 namespace Slicer {
 
+class TaskRunner;
+
 class Task {
 public:
 	Task(const std::function<void()>& funcExecute,
@@ -29,6 +31,7 @@ public:
 
     [[nodiscard]] bool isCanceled() const;
 
+	// A canceled task that is still queued is removed from the queue right away
 	void cancel();
 	void execute();
 	void postExecute();
@@ -37,6 +40,9 @@ private:
 	std::atomic_bool m_isCanceled = false;
 	std::function<void()> m_funcExecute;
 	std::function<void()> m_funcPostExecute;
+	std::atomic<TaskRunner*> m_runner = nullptr; // Only set while the task is queued
+
+	friend class TaskRunner;
 };
 
 } // namespace Slicer
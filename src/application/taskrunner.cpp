@@ -16,36 +16,171 @@
 
 #include "taskrunner.hpp"
 #include <glibmm/main.h>
+#include <logger.hpp>
 
 namespace Slicer {
 
-static const int numThreads = 1;
-
-TaskRunner::TaskRunner()
-    : m_threadpool{numThreads}
+TaskRunner::TaskRunner(unsigned int numThreads)
 {
+    const unsigned int numWorkers = effectiveNumberOfThreads(numThreads);
+
+    for (unsigned int i = 0; i < numWorkers; ++i)
+        m_workers.emplace_back(&TaskRunner::workerLoop, this);
 }
 
 TaskRunner::~TaskRunner()
 {
-    m_threadpool.wait();
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        m_isStopping = true;
+
+        for (auto& [position, queuedTask] : m_queue) {
+            queuedTask.task->m_runner = nullptr;
+            queuedTask.task->cancel();
+        }
+
+        m_queue.clear();
+        m_queuePositions.clear();
+        m_tasksByOwner.clear();
+    }
+
+    m_taskAvailable.notify_all();
+
+    for (std::thread& worker : m_workers)
+        worker.join();
+
+    std::lock_guard<std::mutex> lock{m_completedTasksMutex};
+    m_dispatchConnection.disconnect();
+    m_completedTasks.clear();
 }
 
-void TaskRunner::queueBack(const std::shared_ptr<Task>& task)
+unsigned int TaskRunner::effectiveNumberOfThreads(unsigned int numThreads)
 {
-    m_threadpool.push([task]() {
-        runTask(task);
-    });
+    if (numThreads != 0)
+        return numThreads;
+
+    const unsigned int numCores = std::thread::hardware_concurrency();
+
+    return numCores != 0 ? numCores : 1;
+}
+
+void TaskRunner::queue(const std::shared_ptr<Task>& task,
+                       Priority priority,
+                       const void* owner)
+{
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+
+        if (owner != nullptr) {
+            if (auto it = m_tasksByOwner.find(owner); it != m_tasksByOwner.end()) {
+                // Removing it first means that cancel() won't call us back
+                std::shared_ptr<Task> supersededTask = m_queue.at(m_queuePositions.at(it->second)).task;
+                removeFromQueue(supersededTask.get());
+                supersededTask->cancel();
+            }
+
+            m_tasksByOwner[owner] = task.get();
+        }
+
+        const QueuePosition position{priority, m_nextSequenceNumber++};
+        m_queue.emplace(position, QueuedTask{task, owner});
+        m_queuePositions[task.get()] = position;
+        task->m_runner = this;
+    }
+
+    m_taskAvailable.notify_one();
+}
+
+void TaskRunner::setPriority(const std::shared_ptr<Task>& task, Priority priority)
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+
+    auto it = m_queuePositions.find(task.get());
+
+    // The task already started running, or it was never queued
+    if (it == m_queuePositions.end() || it->second.first == priority)
+        return;
+
+    // The sequence number is kept, so the task doesn't lose its place
+    // relative to the tasks that were queued before it
+    auto queueIt = m_queue.find(it->second);
+    QueuedTask queuedTask = std::move(queueIt->second);
+    m_queue.erase(queueIt);
+
+    it->second.first = priority;
+    m_queue.emplace(it->second, std::move(queuedTask));
+}
+
+void TaskRunner::removeFromQueue(const Task* task)
+{
+    auto it = m_queuePositions.find(task);
+
+    if (it == m_queuePositions.end())
+        return;
+
+    auto queueIt = m_queue.find(it->second);
+    const void* owner = queueIt->second.owner;
+
+    if (owner != nullptr) {
+        auto ownerIt = m_tasksByOwner.find(owner);
+
+        if (ownerIt != m_tasksByOwner.end() && ownerIt->second == task)
+            m_tasksByOwner.erase(ownerIt);
+    }
+
+    queueIt->second.task->m_runner = nullptr;
+    m_queue.erase(queueIt);
+    m_queuePositions.erase(it);
 }
 
-void TaskRunner::queueFront(const std::shared_ptr<Task>& task)
+void TaskRunner::dropCanceledTask(const Task* task)
 {
-    std::thread{[this, task]() {
-        m_threadpool.apply_for(1, [task]() {
-            runTask(task);
-        });
-    }}
-        .detach();
+    std::lock_guard<std::mutex> lock{m_mutex};
+
+    // Does nothing if a worker took the task in the meantime
+    removeFromQueue(task);
+}
+
+void TaskRunner::setPrefetchPaused(bool paused)
+{
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        m_isPrefetchPaused = paused;
+    }
+
+    m_taskAvailable.notify_all();
+}
+
+bool TaskRunner::hasRunnableTask() const
+{
+    if (m_queue.empty())
+        return false;
+
+    // The queue is sorted by priority, so only prefetch and background tasks
+    // are left if the first one is one of them
+    return !m_isPrefetchPaused || m_queue.begin()->first.first < Priority::Prefetch;
+}
+
+void TaskRunner::workerLoop()
+{
+    while (true) {
+        std::shared_ptr<Task> task;
+
+        {
+            std::unique_lock<std::mutex> lock{m_mutex};
+            m_taskAvailable.wait(lock, [this]() {
+                return m_isStopping || hasRunnableTask();
+            });
+
+            if (m_isStopping)
+                return;
+
+            task = m_queue.begin()->second.task;
+            removeFromQueue(task.get());
+        }
+
+        runTask(task);
+    }
 }
 
 void TaskRunner::runTask(const std::shared_ptr<Task>& task)
@@ -53,17 +188,56 @@ void TaskRunner::runTask(const std::shared_ptr<Task>& task)
     if (task->isCanceled())
         return;
 
-    task->execute();
+    try {
+        task->execute();
+    }
+    catch (const std::exception& e) {
+        Logger::logError(std::string{"A background task failed: "} + e.what());
+        return;
+    }
 
     if (task->isCanceled())
         return;
 
-    Glib::signal_idle().connect([task]() {
+    queueCompletedTask(task);
+}
+
+void TaskRunner::queueCompletedTask(const std::shared_ptr<Task>& task)
+{
+    std::lock_guard<std::mutex> lock{m_completedTasksMutex};
+
+    m_completedTasks.push_back(task);
+
+    if (!m_dispatchConnection.connected())
+        m_dispatchConnection = Glib::signal_idle().connect(sigc::mem_fun(*this, &TaskRunner::dispatchCompletedTasks));
+}
+
+bool TaskRunner::dispatchCompletedTasks()
+{
+    const auto start = std::chrono::steady_clock::now();
+
+    while (true) {
+        std::shared_ptr<Task> task;
+
+        {
+            std::lock_guard<std::mutex> lock{m_completedTasksMutex};
+
+            if (m_completedTasks.empty()) {
+                m_dispatchConnection.disconnect();
+                return false;
+            }
+
+            task = std::move(m_completedTasks.front());
+            m_completedTasks.pop_front();
+        }
+
         if (!task->isCanceled())
             task->postExecute();
 
-        return false;
-    });
+        // Let GTK lay out and draw what we have so far, and continue on the next iteration
+        if (std::chrono::steady_clock::now() - start >= dispatchBudget)
+            return true;
+    }
 }
 
 } // namespace Slicer
@@ -18,13 +18,33 @@
 #define SLICER_TASKRUNNER_HPP
 
 #include "task.hpp"
-#include <threadpool.hpp>
+#include <sigc++/connection.h>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
 
 namespace Slicer {
 
 class TaskRunner {
 public:
-	TaskRunner();
+	// From most to least urgent
+	enum class Priority {
+		Preview,
+		Draft,
+		Visible,
+		Prefetch,
+		Background
+	};
+
+	// A value of zero creates one rendering thread per core
+	explicit TaskRunner(unsigned int numThreads = 0);
 
     TaskRunner(const TaskRunner&) = delete;
     TaskRunner& operator=(const TaskRunner&) = delete;
@@ -33,13 +53,55 @@ public:
 
 	~TaskRunner();
 
-	void queueBack(const std::shared_ptr<Task>& task);
-	void queueFront(const std::shared_ptr<Task>& task);
+	// Tasks run by priority, and in queuing order within the same priority.
+	// A queued task with the same owner as the new one is canceled and dropped,
+	// since its result would be superseded anyway.
+	void queue(const std::shared_ptr<Task>& task,
+	           Priority priority,
+	           const void* owner = nullptr);
+	void setPriority(const std::shared_ptr<Task>& task, Priority priority);
+
+	// Prefetch and background tasks stay queued while paused, and other tasks keep running
+	void setPrefetchPaused(bool paused);
 
 private:
-    static void runTask(const std::shared_ptr<Task>& task);
+	using QueuePosition = std::pair<Priority, std::uint64_t>;
+
+	struct QueuedTask {
+		std::shared_ptr<Task> task;
+		const void* owner;
+	};
+
+	std::map<QueuePosition, QueuedTask> m_queue;
+	std::unordered_map<const Task*, QueuePosition> m_queuePositions;
+	std::unordered_map<const void*, const Task*> m_tasksByOwner;
+	std::uint64_t m_nextSequenceNumber = 0;
+	bool m_isStopping = false;
+	bool m_isPrefetchPaused = false;
+	std::mutex m_mutex;
+	std::condition_variable m_taskAvailable;
+	std::vector<std::thread> m_workers;
+
+	// Finished tasks waiting for their postExecute() on the main thread.
+	// A single idle source drains them in batches, instead of one source per task.
+	std::deque<std::shared_ptr<Task>> m_completedTasks;
+	std::mutex m_completedTasksMutex;
+	sigc::connection m_dispatchConnection;
+
+	// Time spent applying results in one main loop iteration,
+	// so that a burst of finished renders doesn't skip frames
+	static constexpr std::chrono::milliseconds dispatchBudget{8};
+
+	void workerLoop();
+	bool hasRunnableTask() const;
+	void removeFromQueue(const Task* task);
+	void dropCanceledTask(const Task* task);
+	void runTask(const std::shared_ptr<Task>& task);
+	void queueCompletedTask(const std::shared_ptr<Task>& task);
+	bool dispatchCompletedTasks();
+	static unsigned int effectiveNumberOfThreads(unsigned int numThreads);
 
-	astp::ThreadPool m_threadpool;
+	friend class Task; // For dropCanceledTask()
 };
 
 } // namespace Slicer
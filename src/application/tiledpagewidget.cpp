@@ -0,0 +1,173 @@
+// PDF Slicer
+// Copyright (C) 2019 Julián Unrrein
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "tiledpagewidget.hpp"
+#include <pagerenderer.hpp>
+#include <gdkmm/general.h>
+#include <algorithm>
+#include <cstdlib>
+#include <numeric>
+
+namespace Slicer {
+
+TiledPageWidget::TiledPageWidget(const Glib::RefPtr<const Page>& page,
+                                 int targetSize,
+                                 TaskRunner& taskRunner)
+    : m_page{page}
+    , m_targetSize{targetSize}
+    , m_taskRunner{taskRunner}
+{
+    set_valign(Gtk::ALIGN_CENTER);
+    set_halign(Gtk::ALIGN_CENTER);
+
+    createTiles();
+}
+
+TiledPageWidget::~TiledPageWidget()
+{
+    cancelRendering();
+}
+
+void TiledPageWidget::changeSize(int targetSize)
+{
+    if (targetSize == m_targetSize)
+        return;
+
+    cancelRendering();
+    m_targetSize = targetSize;
+    createTiles();
+    queue_draw();
+}
+
+void TiledPageWidget::createTiles()
+{
+    const Page::Size pageSize = m_page->scaledRotatedSize(m_targetSize);
+    set_size_request(pageSize.width, pageSize.height);
+
+    m_tiles.clear();
+
+    for (int y = 0; y < pageSize.height; y += tileSize) {
+        for (int x = 0; x < pageSize.width; x += tileSize) {
+            const Gdk::Rectangle area{x,
+                                      y,
+                                      std::min(tileSize, pageSize.width - x),
+                                      std::min(tileSize, pageSize.height - y)};
+            m_tiles.push_back({area, {}, {}});
+        }
+    }
+}
+
+void TiledPageWidget::setVisibleArea(const Gdk::Rectangle& visibleArea)
+{
+    m_visibleArea = visibleArea;
+    renderTiles();
+}
+
+void TiledPageWidget::renderTiles()
+{
+    // Visible tiles go first, starting with the ones closest to the center of the viewport,
+    // and the rest are filled in afterwards
+    const int centerX = m_visibleArea.get_x() + m_visibleArea.get_width() / 2;
+    const int centerY = m_visibleArea.get_y() + m_visibleArea.get_height() / 2;
+
+    auto distanceToCenter = [&](const Tile& tile) {
+        const Gdk::Rectangle& area = tile.area;
+        return std::abs(area.get_x() + area.get_width() / 2 - centerX)
+               + std::abs(area.get_y() + area.get_height() / 2 - centerY);
+    };
+
+    std::vector<std::size_t> order(m_tiles.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) {
+        return distanceToCenter(m_tiles[a]) < distanceToCenter(m_tiles[b]);
+    });
+
+    for (std::size_t tileIndex : order) {
+        Tile& tile = m_tiles[tileIndex];
+
+        if (tile.pixbuf)
+            continue;
+
+        const TaskRunner::Priority priority = m_visibleArea.intersects(tile.area)
+                                                  ? TaskRunner::Priority::Preview
+                                                  : TaskRunner::Priority::Prefetch;
+
+        if (std::shared_ptr<Task> task = tile.renderingTask.lock(); task != nullptr && !task->isCanceled())
+            m_taskRunner.setPriority(task, priority);
+        else
+            renderTile(tileIndex, priority);
+    }
+}
+
+void TiledPageWidget::renderTile(std::size_t tileIndex, TaskRunner::Priority priority)
+{
+    Tile& tile = m_tiles[tileIndex];
+    auto pixbuf = std::make_shared<Glib::RefPtr<Gdk::Pixbuf>>();
+
+    auto funcExecute = [page = m_page,
+                        rotation = m_page->currentRotation(),
+                        targetSize = m_targetSize,
+                        area = tile.area,
+                        pixbuf]() {
+        *pixbuf = PageRenderer{page, rotation}.renderArea(targetSize, area);
+    };
+
+    // Tasks are canceled whenever the tiles are recreated or the widget is destroyed,
+    // so the tile is still there when this runs
+    auto funcPostExecute = [this, tileIndex, pixbuf]() {
+        Tile& renderedTile = m_tiles[tileIndex];
+        renderedTile.pixbuf = *pixbuf;
+
+        const Gdk::Rectangle& area = renderedTile.area;
+        queue_draw_area(area.get_x(), area.get_y(), area.get_width(), area.get_height());
+    };
+
+    auto task = std::make_shared<Task>(funcExecute, funcPostExecute);
+    tile.renderingTask = task;
+    m_taskRunner.queue(task, priority, &tile);
+}
+
+void TiledPageWidget::cancelRendering()
+{
+    for (Tile& tile : m_tiles) {
+        if (auto task = tile.renderingTask.lock(); task != nullptr)
+            task->cancel();
+    }
+}
+
+bool TiledPageWidget::on_draw(const Cairo::RefPtr<Cairo::Context>& cr)
+{
+    const Page::Size pageSize = m_page->scaledRotatedSize(m_targetSize);
+
+    // Tiles that aren't rendered yet show up as blank paper
+    cr->set_source_rgb(1, 1, 1);
+    cr->rectangle(0, 0, pageSize.width, pageSize.height);
+    cr->fill();
+
+    for (const Tile& tile : m_tiles) {
+        if (!tile.pixbuf)
+            continue;
+
+        const Gdk::Rectangle& area = tile.area;
+        Gdk::Cairo::set_source_pixbuf(cr, tile.pixbuf, area.get_x(), area.get_y());
+        cr->rectangle(area.get_x(), area.get_y(), area.get_width(), area.get_height());
+        cr->fill();
+    }
+
+    return true;
+}
+
+} // namespace Slicer
@@ -0,0 +1,73 @@
+// PDF Slicer
+// Copyright (C) 2019 Julián Unrrein
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef TILEDPAGEWIDGET_HPP
+#define TILEDPAGEWIDGET_HPP
+
+#include "taskrunner.hpp"
+#include <page.hpp>
+#include <gtkmm/drawingarea.h>
+
+namespace Slicer {
+
+// Shows a page at a large size, rendering it in tiles so that
+// the part that is being looked at appears first
+class TiledPageWidget : public Gtk::DrawingArea {
+public:
+    TiledPageWidget(const Glib::RefPtr<const Page>& page,
+                    int targetSize,
+                    TaskRunner& taskRunner);
+
+    TiledPageWidget(const TiledPageWidget&) = delete;
+    TiledPageWidget& operator=(const TiledPageWidget&) = delete;
+    TiledPageWidget(TiledPageWidget&&) = delete;
+    TiledPageWidget& operator=(TiledPageWidget&& src) = delete;
+
+    ~TiledPageWidget() override;
+
+    void changeSize(int targetSize);
+
+    // In widget coordinates. Tiles in this area are rendered before the rest.
+    void setVisibleArea(const Gdk::Rectangle& visibleArea);
+
+    void cancelRendering();
+
+protected:
+    bool on_draw(const Cairo::RefPtr<Cairo::Context>& cr) override;
+
+private:
+    struct Tile {
+        Gdk::Rectangle area;
+        Glib::RefPtr<Gdk::Pixbuf> pixbuf;
+        std::weak_ptr<Task> renderingTask;
+    };
+
+    static constexpr int tileSize = 512;
+
+    Glib::RefPtr<const Page> m_page;
+    int m_targetSize;
+    TaskRunner& m_taskRunner;
+    std::vector<Tile> m_tiles;
+    Gdk::Rectangle m_visibleArea;
+
+    void createTiles();
+    void renderTiles();
+    void renderTile(std::size_t tileIndex, TaskRunner::Priority priority);
+};
+
+} // namespace Slicer
+
+#endif // TILEDPAGEWIDGET_HPP
@@ -16,36 +16,39 @@
 
 #include "view.hpp"
 #include "previewwindow.hpp"
+#include <pagerenderer.hpp>
+#include <pixeloperations.hpp>
 #include <glibmm/main.h>
-#include <range/v3/view.hpp>
-#include <range/v3/range/conversion.hpp>
+#include <algorithm>
+#include <unordered_map>
 
 namespace Slicer {
 
-namespace rsv = ranges::views;
-
 View::View(TaskRunner& taskRunner,
+           ThumbnailCache& thumbnailCache,
            const std::function<void()>& onMouseWheelUp,
            const std::function<void()>& onMouseWheelDown)
     : m_taskRunner{taskRunner}
+    , m_thumbnailCache{thumbnailCache}
 {
-    setupFlowbox();
+    setupLayout();
     setupSignalHandlers(onMouseWheelUp, onMouseWheelDown);
 }
 
-void View::setupFlowbox()
+void View::setupLayout()
 {
-    m_flowBox.set_row_spacing(5);
-    m_flowBox.set_selection_mode(Gtk::SELECTION_NONE);
-    m_flowBox.set_sort_func(&sortFunction);
-
-    add(m_flowBox);
+    // The number of columns depends on the width, so widgets are placed again
+    signal_size_allocate().connect([this](Gtk::Allocation&) {
+        queueRenderPagesNearViewport();
+    });
 }
 
 void View::setupSignalHandlers(const std::function<void()>& onMouseWheelUp,
                                const std::function<void()>& onMouseWheelDown)
 {
-    add_events(Gdk::SCROLL_MASK | Gdk::SMOOTH_SCROLL_MASK);
+    add_events(Gdk::SCROLL_MASK | Gdk::SMOOTH_SCROLL_MASK | Gdk::KEY_PRESS_MASK);
+
+    signal_key_press_event().connect(sigc::mem_fun(*this, &View::onKeyPressed), false);
 
     signal_scroll_event().connect([onMouseWheelUp, onMouseWheelDown](GdkEventScroll* event) {
         if ((event->state & Gdk::CONTROL_MASK) != 0) {
@@ -69,6 +72,11 @@ View::~View()
     for (sigc::connection& connection : m_documentConnections)
         connection.disconnect();
 
+    for (sigc::connection& connection : m_adjustmentConnections)
+        connection.disconnect();
+
+    m_renderNearViewportConnection.disconnect();
+
     cancelRenderingTasks();
 }
 
@@ -79,19 +87,243 @@ std::shared_ptr<InteractivePageWidget> View::createPageWidget(const Glib::RefPtr
     pageWidget->selectedChanged.connect(sigc::mem_fun(*this, &View::onPageSelection));
     pageWidget->shiftSelected.connect(sigc::mem_fun(*this, &View::onShiftSelection));
     pageWidget->previewRequested.connect(sigc::mem_fun(*this, &View::onPreviewRequested));
+    put(*pageWidget, 0, 0);
+
+    return pageWidget;
+}
+
+std::shared_ptr<InteractivePageWidget> View::bindPageWidget(unsigned int position)
+{
+    const Glib::RefPtr<const Page> page = m_document->getPage(position);
+    std::shared_ptr<InteractivePageWidget> pageWidget;
+
+    if (m_recycledWidgets.empty()) {
+        pageWidget = createPageWidget(page);
+    }
+    else {
+        pageWidget = m_recycledWidgets.back();
+        m_recycledWidgets.pop_back();
+    }
+
+    pageWidget->bind(page, position);
+    pageWidget->setSelected(m_selection.isSelected(position));
+    placePageWidget(*pageWidget);
+    pageWidget->show();
+
+    m_boundWidgets[position] = pageWidget;
 
     return pageWidget;
 }
 
+void View::recyclePageWidget(const std::shared_ptr<InteractivePageWidget>& pageWidget)
+{
+    // Also cancels its rendering. The thumbnail cache has it if the page comes back.
+    pageWidget->dropThumbnail();
+    pageWidget->hide();
+
+    m_recycledWidgets.push_back(pageWidget);
+}
+
+void View::recycleAllPageWidgets()
+{
+    for (auto& [position, pageWidget] : m_boundWidgets)
+        recyclePageWidget(pageWidget);
+
+    m_boundWidgets.clear();
+}
+
+void View::placePageWidget(InteractivePageWidget& pageWidget)
+{
+    const int gridWidth = static_cast<int>(m_columns) * cellWidth();
+    const int offset = std::max(0, (get_allocated_width() - gridWidth) / 2);
+    const unsigned int row = pageWidget.position() / m_columns;
+    const unsigned int column = pageWidget.position() % m_columns;
+
+    // Cells are square, so the grid doesn't depend on the shape of each page
+    pageWidget.set_size_request(m_pageWidgetSize, m_pageWidgetSize + labelsHeight());
+    move(pageWidget, offset + static_cast<int>(column) * cellWidth(), static_cast<int>(row) * rowHeight());
+}
+
+void View::updateLayout()
+{
+    const int width = get_allocated_width();
+    m_columns = static_cast<unsigned int>(std::max(1, width / cellWidth()));
+
+    const unsigned int rows = (numberOfPages() + m_columns - 1) / m_columns;
+    const auto layoutWidth = static_cast<guint>(std::max(width, cellWidth()));
+    const auto layoutHeight = static_cast<guint>(rows * rowHeight());
+
+    guint currentWidth = 0;
+    guint currentHeight = 0;
+    get_size(currentWidth, currentHeight);
+
+    // Setting the same size again would still notify the adjustments
+    if (layoutWidth != currentWidth || layoutHeight != currentHeight)
+        set_size(layoutWidth, layoutHeight);
+
+    for (auto& [position, pageWidget] : m_boundWidgets)
+        placePageWidget(*pageWidget);
+}
+
+bool View::updateBoundWidgets()
+{
+    const unsigned int pagesCount = numberOfPages();
+
+    if (pagesCount == 0 || m_verticalAdjustment == nullptr) {
+        recycleAllPageWidgets();
+        return true;
+    }
+
+    const double visibleTop = m_verticalAdjustment->get_value();
+    const double visibleBottom = visibleTop + m_verticalAdjustment->get_page_size();
+    const double margin = m_prefetchMargin * m_verticalAdjustment->get_page_size();
+    const RowRange visibleRows = rowsBetween(visibleTop, visibleBottom);
+    const RowRange rows = rowsBetween(visibleTop - margin, visibleBottom + margin);
+    const unsigned int first = rows.first * m_columns;
+    const unsigned int last = std::min(pagesCount - 1, (rows.last + 1) * m_columns - 1);
+
+    for (auto it = m_boundWidgets.begin(); it != m_boundWidgets.end();) {
+        if (it->first < first || it->first > last) {
+            recyclePageWidget(it->second);
+            it = m_boundWidgets.erase(it);
+        }
+        else {
+            ++it;
+        }
+    }
+
+    for (unsigned int row = visibleRows.first; row <= visibleRows.last; ++row)
+        bindRow(row);
+
+    // The rest of the range goes nearest rows first, in chunks, so that
+    // opening a document or adding many pages doesn't freeze the window.
+    // There is no progress to report: the work left is bounded by the prefetch
+    // rows, not by the size of the document, and it ends within a few chunks.
+    const auto start = std::chrono::steady_clock::now();
+
+    for (unsigned int distance = 1;
+         visibleRows.last + distance <= rows.last || visibleRows.first >= rows.first + distance;
+         ++distance) {
+        if (std::chrono::steady_clock::now() - start >= bindingBudget)
+            return false;
+
+        if (visibleRows.last + distance <= rows.last)
+            bindRow(visibleRows.last + distance);
+
+        if (visibleRows.first >= rows.first + distance)
+            bindRow(visibleRows.first - distance);
+    }
+
+    return true;
+}
+
+void View::bindRow(unsigned int row)
+{
+    const unsigned int end = std::min(numberOfPages(), (row + 1) * m_columns);
+
+    for (unsigned int position = row * m_columns; position < end; ++position) {
+        if (m_boundWidgets.count(position) == 0)
+            bindPageWidget(position);
+    }
+}
+
+void View::updateSelectedWidgets()
+{
+    for (auto& [position, pageWidget] : m_boundWidgets)
+        pageWidget->setSelected(m_selection.isSelected(position));
+}
+
+void View::notifySelectionChanged()
+{
+    if (m_selectionBatchDepth != 0) {
+        m_isSelectionChanged = true;
+        return;
+    }
+
+    updateSelectedWidgets();
+    selectedPagesChanged.emit();
+}
+
+View::SelectionBatch::SelectionBatch(View& view)
+    : m_view{view}
+{
+    ++m_view.m_selectionBatchDepth;
+}
+
+View::SelectionBatch::~SelectionBatch()
+{
+    if (--m_view.m_selectionBatchDepth == 0 && m_view.m_isSelectionChanged) {
+        m_view.m_isSelectionChanged = false;
+        m_view.notifySelectionChanged();
+    }
+}
+
+int View::labelsHeight()
+{
+    if (m_labelsHeight >= 0)
+        return m_labelsHeight;
+
+    // All pages have labels of the same height, so any widget will do
+    std::shared_ptr<InteractivePageWidget> pageWidget;
+
+    if (!m_boundWidgets.empty()) {
+        pageWidget = m_boundWidgets.begin()->second;
+    }
+    else if (!m_recycledWidgets.empty()) {
+        pageWidget = m_recycledWidgets.back();
+    }
+    else if (numberOfPages() != 0) {
+        pageWidget = createPageWidget(m_document->getPage(0));
+        pageWidget->hide();
+        m_recycledWidgets.push_back(pageWidget);
+    }
+    else {
+        return 0;
+    }
+
+    m_labelsHeight = pageWidget->labelsHeight();
+
+    return m_labelsHeight;
+}
+
+int View::cellWidth() const
+{
+    return m_pageWidgetSize + 2 * cellMargin;
+}
+
+int View::rowHeight()
+{
+    return m_pageWidgetSize + labelsHeight() + rowSpacing;
+}
+
+View::RowRange View::rowsBetween(double top, double bottom)
+{
+    const unsigned int rows = (numberOfPages() + m_columns - 1) / m_columns;
+    const double height = rowHeight();
+
+    if (rows == 0 || height <= 0)
+        return {0, 0};
+
+    const auto rowAt = [rows, height](double y) {
+        return std::min(rows - 1, static_cast<unsigned int>(std::max(0.0, y) / height));
+    };
+
+    return {rowAt(top), rowAt(bottom)};
+}
+
+unsigned int View::numberOfPages() const
+{
+    return m_document != nullptr ? m_document->numberOfPages() : 0;
+}
+
 void View::clearState()
 {
     cancelRenderingTasks();
-    clearSelection();
-
-    for (Gtk::Widget* child : m_flowBox.get_children())
-        m_flowBox.remove(*child);
 
-    m_pageWidgets.clear();
+    // Widgets are kept for the pages of the next document
+    recycleAllPageWidgets();
+    m_selection.reset(0);
+    m_lastPageSelected.reset();
 
     for (sigc::connection& connection : m_documentConnections)
         connection.disconnect();
@@ -105,17 +337,16 @@ void View::setDocument(Document& document, int targetWidgetSize)
 
     m_document = &document;
     m_pageWidgetSize = targetWidgetSize;
+    m_selection.reset(m_document->numberOfPages());
 
-    for (unsigned int i = 0; i < m_document->numberOfPages(); ++i) {
-        auto page = m_document->getPage(i);
-        std::shared_ptr<InteractivePageWidget> pageWidget = createPageWidget(page);
-        m_pageWidgets.push_back(pageWidget);
-        m_flowBox.add(*pageWidget);
-        renderPage(pageWidget);
+    for (auto& pageWidget : m_recycledWidgets)
+        pageWidget->changeSize(m_pageWidgetSize);
 
-        if (i == 0)
-            pageWidget->grab_focus();
-    }
+    updateLayout();
+    updateBoundWidgets();
+
+    if (auto it = m_boundWidgets.find(0); it != m_boundWidgets.end())
+        it->second->grab_focus();
 
     m_documentConnections.emplace_back(
         m_document->pages()->signal_items_changed().connect(sigc::mem_fun(*this, &View::onModelItemsChanged)));
@@ -123,7 +354,44 @@ void View::setDocument(Document& document, int targetWidgetSize)
         m_document->pagesRotated.connect(sigc::mem_fun(*this, &View::onModelPagesRotated)));
     m_documentConnections.emplace_back(
         m_document->pagesReordered.connect(sigc::mem_fun(*this, &View::onModelPagesReordered)));
-    selectedPagesChanged.emit();
+    m_documentConnections.emplace_back(
+        m_document->pagesPermuted.connect(sigc::mem_fun(*this, &View::onModelPagesPermuted)));
+    m_documentConnections.emplace_back(
+        m_document->pagesRemoved.connect(sigc::mem_fun(*this, &View::onModelPagesRemoved)));
+    m_documentConnections.emplace_back(
+        m_document->pagesInserted.connect(sigc::mem_fun(*this, &View::onModelPagesInserted)));
+    notifySelectionChanged();
+    queueRenderPagesNearViewport();
+}
+
+void View::setVerticalAdjustment(const Glib::RefPtr<Gtk::Adjustment>& adjustment)
+{
+    for (sigc::connection& connection : m_adjustmentConnections)
+        connection.disconnect();
+
+    m_adjustmentConnections.clear();
+    m_verticalAdjustment = adjustment;
+
+    // Keyboard navigation scrolls to the focused page
+    set_focus_vadjustment(m_verticalAdjustment);
+
+    m_adjustmentConnections.emplace_back(
+        m_verticalAdjustment->signal_value_changed().connect(sigc::mem_fun(*this, &View::queueRenderPagesNearViewport)));
+    m_adjustmentConnections.emplace_back(
+        m_verticalAdjustment->signal_changed().connect(sigc::mem_fun(*this, &View::queueRenderPagesNearViewport)));
+}
+
+void View::setPrefetchMargin(double screens)
+{
+    m_prefetchMargin = screens;
+    queueRenderPagesNearViewport();
+}
+
+void View::setSpeculativePageSizes(const std::vector<int>& sizes)
+{
+    m_speculativePageSizes = sizes;
+    cancelSpeculativeRendering();
+    queueRenderPagesNearViewport();
 }
 
 void View::changePageSize(int targetWidgetSize)
@@ -132,11 +400,27 @@ void View::changePageSize(int targetWidgetSize)
 
     m_pageWidgetSize = targetWidgetSize;
 
-    for (auto& pageWidget : m_pageWidgets) {
+    // Only pages near the visible area have widgets, so scaling their thumbnails is cheap
+    for (auto& [position, pageWidget] : m_boundWidgets) {
+        // They keep showing their old thumbnail, scaled, until the new one arrives
+        Glib::RefPtr<Gdk::Pixbuf> oldThumbnail = pageWidget->thumbnail();
+
         pageWidget->changeSize(m_pageWidgetSize);
-        pageWidget->showSpinner();
-        renderPage(pageWidget);
+
+        if (oldThumbnail) {
+            const Page::Size size = pageWidget->page()->scaledRotatedSize(m_pageWidgetSize);
+            pageWidget->setDraftThumbnail(oldThumbnail->scale_simple(size.width, size.height, Gdk::INTERP_BILINEAR));
+        }
+        else {
+            pageWidget->showSpinner();
+        }
     }
+
+    for (auto& pageWidget : m_recycledWidgets)
+        pageWidget->changeSize(m_pageWidgetSize);
+
+    updateLayout();
+    queueRenderPagesNearViewport();
 }
 
 void View::setShowFileNames(bool showFileNames)
@@ -146,8 +430,16 @@ void View::setShowFileNames(bool showFileNames)
 
     m_showFileNames = showFileNames;
 
-    for (auto& pageWidget : m_pageWidgets)
+    for (auto& [position, pageWidget] : m_boundWidgets)
+        pageWidget->setShowFilename(showFileNames);
+
+    for (auto& pageWidget : m_recycledWidgets)
         pageWidget->setShowFilename(showFileNames);
+
+    // The labels take another height
+    m_labelsHeight = -1;
+    updateLayout();
+    queueRenderPagesNearViewport();
 }
 
 void View::selectPageRange(unsigned int first, unsigned int last)
@@ -155,216 +447,555 @@ void View::selectPageRange(unsigned int first, unsigned int last)
     if (first > last || last > m_document->numberOfPages() - 1)
         throw std::runtime_error("Incorrect parameters");
 
-    clearSelection();
-
-    for (auto& widget : m_pageWidgets | rsv::drop(first) | rsv::take(last - first + 1))
-        widget->setSelected(true);
+    m_selection.clear();
+    m_selection.select(first, last);
+    m_lastPageSelected.reset();
 
-    selectedPagesChanged.emit();
+    notifySelectionChanged();
 }
 
 void View::selectAllPages()
 {
-    for (auto& widget : m_pageWidgets)
-        widget->setSelected(true);
-
-    m_lastPageSelected = nullptr;
+    m_selection.selectAll();
+    m_lastPageSelected.reset();
 
-    selectedPagesChanged.emit();
+    notifySelectionChanged();
 }
 
 void View::selectOddPages()
 {
-    for (auto [i, widget] : rsv::enumerate(m_pageWidgets)) {
-        if (i % 2 == 0)
-            widget->setSelected(true);
-        else
-            widget->setSelected(false);
-    }
+    m_selection.selectEveryOther(0);
 
-    m_lastPageSelected = nullptr;
+    m_lastPageSelected.reset();
 
-    selectedPagesChanged.emit();
+    notifySelectionChanged();
 }
 
 void View::selectEvenPages()
 {
-    for (auto [i, widget] : rsv::enumerate(m_pageWidgets)) {
-        if (i % 2 == 1)
-            widget->setSelected(true);
-        else
-            widget->setSelected(false);
-    }
+    m_selection.selectEveryOther(1);
 
-    m_lastPageSelected = nullptr;
+    m_lastPageSelected.reset();
 
-    selectedPagesChanged.emit();
+    notifySelectionChanged();
 }
 
 void View::invertSelection()
 {
-    for (auto& widget: m_pageWidgets)
-        widget->setSelected(!widget->getSelected());
-    
-    m_lastPageSelected = nullptr;
-    
-    selectedPagesChanged.emit();
+    m_selection.invert();
+    m_lastPageSelected.reset();
+
+    notifySelectionChanged();
 }
 
 void View::clearSelection()
 {
-    for (auto& widget : m_pageWidgets)
-        widget->setSelected(false);
+    m_selection.clear();
+    m_lastPageSelected.reset();
 
-    m_lastPageSelected = nullptr;
+    notifySelectionChanged();
+}
 
-    selectedPagesChanged.emit();
+const PageSelection& View::selection() const
+{
+    return m_selection;
 }
 
 unsigned int View::getSelectedChildIndex() const
 {
-    const std::vector<unsigned int> selected = getSelectedChildrenIndexes();
-
-    if (selected.size() != 1)
+    if (m_selection.count() != 1)
         throw std::runtime_error("More than one child was actually selected");
 
-    return selected.front();
+    return m_selection.first();
 }
 
 std::vector<unsigned int> View::getSelectedChildrenIndexes() const
 {
-    return m_pageWidgets
-           | rsv::filter(std::mem_fn(&InteractivePageWidget::getSelected))
-           | rsv::transform(std::mem_fn(&InteractivePageWidget::get_index))
-           | ranges::to<std::vector<unsigned int>>;
+    return m_selection.selectedIndexes();
 }
 
 std::vector<unsigned int> View::getUnselectedChildrenIndexes() const
 {
-    return m_pageWidgets
-           | rsv::remove_if(std::mem_fn(&InteractivePageWidget::getSelected))
-           | rsv::transform(std::mem_fn(&InteractivePageWidget::get_index))
-           | ranges::to<std::vector<unsigned int>>;
+    return m_selection.unselectedIndexes();
 }
 
-int View::sortFunction(Gtk::FlowBoxChild* a, Gtk::FlowBoxChild* b)
+void View::renderPage(const std::shared_ptr<InteractivePageWidget>& pageWidget,
+                      TaskRunner::Priority priority)
 {
-    const auto widgetA = dynamic_cast<InteractivePageWidget*>(a);
-    const auto widgetB = dynamic_cast<InteractivePageWidget*>(b);
+    pageWidget->cancelRendering();
+
+    const ThumbnailCache::Key cacheKey{*pageWidget->page(), m_pageWidgetSize};
+
+    if (Glib::RefPtr<Gdk::Pixbuf> cachedThumbnail = m_thumbnailCache.get(cacheKey)) {
+        pageWidget->setThumbnail(cachedThumbnail);
+        pageWidget->showPage();
 
-    return InteractivePageWidget::sortFunction(*widgetA, *widgetB);
+        return;
+    }
+
+    std::weak_ptr<InteractivePageWidget> weakWidget = pageWidget;
+    auto thumbnail = std::make_shared<Glib::RefPtr<Gdk::Pixbuf>>();
+    auto weakTask = std::make_shared<std::weak_ptr<Task>>();
+
+    // Widgets are only touched from the main thread, in funcPostExecute.
+    // The page is rendered with the rotation in the key, as it can be rotated meanwhile.
+    auto funcExecute = [page = pageWidget->page(),
+                        targetSize = m_pageWidgetSize,
+                        cacheKey,
+                        thumbnail,
+                        weakTask,
+                        &thumbnailCache = m_thumbnailCache]() {
+        *thumbnail = thumbnailCache.load(cacheKey);
+
+        if (!*thumbnail) {
+            *thumbnail = PageRenderer{page, cacheKey.rotation}.render(targetSize);
+
+            if (auto task = weakTask->lock(); task != nullptr && !task->isCanceled())
+                thumbnailCache.persist(cacheKey, *thumbnail);
+        }
+    };
+
+    auto funcPostExecute = [weakWidget, thumbnail]() {
+        if (auto widget = weakWidget.lock(); widget != nullptr) {
+            widget->cancelDraft();
+            widget->setThumbnail(*thumbnail);
+            widget->showPage();
+        }
+    };
+
+    auto task = std::make_shared<Task>(funcExecute, funcPostExecute);
+    *weakTask = task;
+    pageWidget->setRenderingTask(task);
+    m_taskRunner.queue(task, priority, pageWidget.get());
 }
 
-void View::renderPage(const std::shared_ptr<InteractivePageWidget>& pageWidget)
+void View::renderDraft(const std::shared_ptr<InteractivePageWidget>& pageWidget)
 {
     std::weak_ptr<InteractivePageWidget> weakWidget = pageWidget;
-
-    auto funcExecute = [weakWidget]() {
-        if (auto widget = weakWidget.lock(); widget != nullptr)
-            widget->renderPage();
+    auto thumbnail = std::make_shared<Glib::RefPtr<Gdk::Pixbuf>>();
+    auto draft = std::make_shared<Glib::RefPtr<Gdk::Pixbuf>>();
+
+    // A thumbnail in the disk cache loads faster than a draft renders,
+    // so when there is one, it's shown right away as the final thumbnail
+    auto funcExecute = [page = pageWidget->page(),
+                        cacheKey = ThumbnailCache::Key{*pageWidget->page(), m_pageWidgetSize},
+                        targetSize = m_pageWidgetSize,
+                        thumbnail,
+                        draft,
+                        &thumbnailCache = m_thumbnailCache]() {
+        *thumbnail = thumbnailCache.load(cacheKey);
+
+        if (!*thumbnail)
+            *draft = PageRenderer{page, cacheKey.rotation}.renderDraft(targetSize);
     };
 
-    auto funcPostExecute = [weakWidget]() {
-        if (auto widget = weakWidget.lock(); widget != nullptr)
+    // The final render cancels the draft, so a late draft never replaces it
+    auto funcPostExecute = [weakWidget, thumbnail, draft]() {
+        if (auto widget = weakWidget.lock(); widget != nullptr) {
+            if (*thumbnail) {
+                widget->cancelRendering();
+                widget->setThumbnail(*thumbnail);
+            }
+            else {
+                widget->setDraftThumbnail(*draft);
+            }
+
             widget->showPage();
+        }
     };
 
     auto task = std::make_shared<Task>(funcExecute, funcPostExecute);
-    pageWidget->setRenderingTask(task);
-    m_taskRunner.queueBack(task);
+    pageWidget->setDraftTask(task);
+    m_taskRunner.queue(task, TaskRunner::Priority::Draft);
+}
+
+void View::queueRenderPagesNearViewport()
+{
+    if (m_renderNearViewportConnection.connected())
+        return;
+
+    // Scrolling and layout changes come in bursts, so the work is done once per burst
+    m_renderNearViewportConnection = Glib::signal_idle().connect(sigc::mem_fun(*this, &View::renderPagesNearViewport));
+}
+
+bool View::renderPagesNearViewport()
+{
+    if (m_verticalAdjustment == nullptr)
+        return false;
+
+    updateLayout();
+    const bool allPagesBound = updateBoundWidgets();
+
+    const double visibleTop = m_verticalAdjustment->get_value();
+    const double visibleBottom = visibleTop + m_verticalAdjustment->get_page_size();
+    const RowRange visibleRows = rowsBetween(visibleTop, visibleBottom);
+    std::vector<std::shared_ptr<InteractivePageWidget>> visibleWidgets;
+
+    // Every bound widget is near the visible area
+    for (auto& [position, pageWidget] : m_boundWidgets) {
+        const unsigned int row = position / m_columns;
+        const TaskRunner::Priority priority = (row >= visibleRows.first && row <= visibleRows.last)
+                                                  ? TaskRunner::Priority::Visible
+                                                  : TaskRunner::Priority::Prefetch;
+
+        if (std::shared_ptr<Task> task = pageWidget->renderingTask(); task != nullptr && !task->isCanceled())
+            m_taskRunner.setPriority(task, priority);
+        else if (pageWidget->needsRendering())
+            renderPage(pageWidget, priority);
+
+        if (priority == TaskRunner::Priority::Visible) {
+            visibleWidgets.push_back(pageWidget);
+
+            // Visible pages show a quick draft until their thumbnail is ready
+            if (pageWidget->needsDraft())
+                renderDraft(pageWidget);
+        }
+    }
+
+    renderSpeculatively(visibleWidgets);
+
+    return !allPagesBound;
+}
+
+void View::dropOffscreenThumbnails()
+{
+    if (m_verticalAdjustment == nullptr)
+        return;
+
+    const double visibleTop = m_verticalAdjustment->get_value();
+    const double visibleBottom = visibleTop + m_verticalAdjustment->get_page_size();
+    const RowRange visibleRows = rowsBetween(visibleTop, visibleBottom);
+
+    for (auto& [position, pageWidget] : m_boundWidgets) {
+        const unsigned int row = position / m_columns;
+
+        if (row < visibleRows.first || row > visibleRows.last)
+            pageWidget->dropThumbnail();
+    }
+
+    // Created again when scrolling needs them
+    m_recycledWidgets.clear();
+}
+
+void View::renderSpeculatively(const std::vector<std::shared_ptr<InteractivePageWidget>>& visibleWidgets)
+{
+    std::vector<const Page*> pages;
+
+    for (const auto& pageWidget : visibleWidgets)
+        pages.push_back(pageWidget->page().get());
+
+    // Still working on the same pages
+    if (pages == m_speculativelyRenderedPages)
+        return;
+
+    cancelSpeculativeRendering();
+    m_speculativelyRenderedPages = pages;
+
+    const std::size_t byteBudget = m_thumbnailCache.byteBudget() / speculativeCacheShare;
+    std::size_t queuedBytes = 0;
+
+    for (int size : m_speculativePageSizes) {
+        for (const auto& pageWidget : visibleWidgets) {
+            const Glib::RefPtr<const Page>& page = pageWidget->page();
+            const ThumbnailCache::Key cacheKey{*page, size};
+
+            if (m_thumbnailCache.contains(cacheKey))
+                continue;
+
+            const Page::Size thumbnailSize = page->scaledRotatedSize(size);
+            queuedBytes += static_cast<std::size_t>(thumbnailSize.width) * thumbnailSize.height * 4;
+
+            if (queuedBytes > byteBudget)
+                return;
+
+            // Nothing to do on the main thread, the thumbnail is picked up from the cache
+            auto weakTask = std::make_shared<std::weak_ptr<Task>>();
+            auto funcExecute = [page, size, cacheKey, weakTask, &thumbnailCache = m_thumbnailCache]() {
+                if (thumbnailCache.load(cacheKey))
+                    return;
+
+                Glib::RefPtr<Gdk::Pixbuf> thumbnail = PageRenderer{page, cacheKey.rotation}.render(size);
+
+                if (auto task = weakTask->lock(); task != nullptr && !task->isCanceled())
+                    thumbnailCache.persist(cacheKey, thumbnail);
+            };
+
+            // Background tasks only run when nothing else is queued
+            auto task = std::make_shared<Task>(funcExecute, []() {});
+            *weakTask = task;
+            m_speculativeTasks.push_back(task);
+            m_taskRunner.queue(task, TaskRunner::Priority::Background);
+        }
+    }
+}
+
+void View::cancelSpeculativeRendering()
+{
+    for (auto& weakTask : m_speculativeTasks) {
+        if (auto task = weakTask.lock(); task != nullptr)
+            task->cancel();
+    }
+
+    m_speculativeTasks.clear();
+    m_speculativelyRenderedPages.clear();
 }
 
 void View::cancelRenderingTasks()
 {
-    for (auto& pageWidget : m_pageWidgets)
+    for (auto& [position, pageWidget] : m_boundWidgets)
         pageWidget->cancelRendering();
+
+    cancelSpeculativeRendering();
 }
 
 void View::onModelItemsChanged(guint position, guint removed, guint added)
 {
-    auto it = m_pageWidgets.begin();
-    std::advance(it, position);
+    if (m_pendingSelection.has_value()) {
+        m_selection = std::move(*m_pendingSelection);
+        m_pendingSelection.reset();
+    }
+    else {
+        m_selection.remove(position, removed);
+        m_selection.insert(position, added);
+    }
+
+    if (m_lastPageSelected.has_value() && *m_lastPageSelected >= position)
+        m_lastPageSelected.reset();
 
-    for (; removed != 0; --removed) {
-        (*it)->cancelRendering();
-        m_flowBox.remove(*(*it));
-        it = m_pageWidgets.erase(it);
+    if (removed != 0)
+        cancelSpeculativeRendering();
+
+    // Widgets after the change keep their page, which is now at another position.
+    // Widgets of removed pages that come back within the change, as when moving
+    // pages, keep their thumbnail too. The other new pages get widgets when laying out.
+    std::map<unsigned int, std::shared_ptr<InteractivePageWidget>> boundWidgets;
+    std::unordered_map<const Page*, std::shared_ptr<InteractivePageWidget>> removedWidgets;
+
+    for (auto& [oldPosition, pageWidget] : m_boundWidgets) {
+        if (oldPosition < position) {
+            boundWidgets.emplace(oldPosition, pageWidget);
+        }
+        else if (oldPosition < position + removed) {
+            removedWidgets.emplace(pageWidget->page().get(), pageWidget);
+        }
+        else {
+            const unsigned int newPosition = oldPosition - removed + added;
+            pageWidget->bind(m_document->getPage(newPosition), newPosition);
+            boundWidgets.emplace(newPosition, pageWidget);
+        }
     }
 
-    for (guint i = 0; i != added; ++i) {
-        auto page = m_document->getPage(position + i);
-        std::shared_ptr<InteractivePageWidget> pageWidget = createPageWidget(page);
+    if (!removedWidgets.empty()) {
+        const unsigned int firstBound = std::max(position, m_boundWidgets.begin()->first);
+        const unsigned int endBound = std::min(position + added, m_boundWidgets.rbegin()->first + 1);
+
+        for (unsigned int newPosition = firstBound; newPosition < endBound; ++newPosition) {
+            const Glib::RefPtr<const Page> page = m_document->getPage(newPosition);
+            auto it = removedWidgets.find(page.get());
 
-        m_pageWidgets.insert(it, pageWidget);
-        m_flowBox.add(*pageWidget);
-        renderPage(pageWidget);
+            if (it != removedWidgets.end()) {
+                it->second->bind(page, newPosition);
+                it->second->setSelected(false);
+                boundWidgets.emplace(newPosition, it->second);
+                removedWidgets.erase(it);
+            }
+        }
     }
 
-    selectedPagesChanged.emit();
+    for (auto& [page, pageWidget] : removedWidgets)
+        recyclePageWidget(pageWidget);
+
+    m_boundWidgets = std::move(boundWidgets);
+
+    updateLayout();
+    notifySelectionChanged();
+    queueRenderPagesNearViewport();
 }
 
 void View::onModelPagesRotated(const std::vector<unsigned int>& positions)
 {
-    for (auto& pageWidget : m_pageWidgets) {
-        for (unsigned int position : positions) {
-            if (position == static_cast<unsigned>(pageWidget->get_index())) {
-                pageWidget->showSpinner();
-                pageWidget->changeSize(m_pageWidgetSize);
-                renderPage(pageWidget);
+    // Their cache keys include the rotation the pages had when queued
+    cancelSpeculativeRendering();
 
-                break;
-            }
+    // Pages without a widget are rendered with their new rotation when they get one
+    for (unsigned int position : positions) {
+        auto it = m_boundWidgets.find(position);
+
+        if (it == m_boundWidgets.end())
+            continue;
+
+        std::shared_ptr<InteractivePageWidget>& pageWidget = it->second;
+        pageWidget->cancelRendering();
+
+        if (!rotateThumbnail(pageWidget)) {
+            pageWidget->showSpinner();
+            pageWidget->changeSize(m_pageWidgetSize);
         }
     }
+
+    queueRenderPagesNearViewport();
+}
+
+bool View::rotateThumbnail(const std::shared_ptr<InteractivePageWidget>& pageWidget)
+{
+    // Drafts and thumbnails of a previous size are not worth keeping
+    Glib::RefPtr<Gdk::Pixbuf> thumbnail = pageWidget->thumbnail();
+
+    if (!thumbnail || pageWidget->needsRendering())
+        return false;
+
+    // A rotation by a multiple of 90 degrees is an exact pixel transform,
+    // so there is no need to go through poppler again
+    const int degrees = pageWidget->page()->currentRotation() - pageWidget->thumbnailRotation();
+    Glib::RefPtr<Gdk::Pixbuf> rotatedThumbnail = PixelOperations::rotate(thumbnail, degrees);
+
+    m_thumbnailCache.insert({*pageWidget->page(), m_pageWidgetSize}, rotatedThumbnail);
+    pageWidget->changeSize(m_pageWidgetSize);
+    pageWidget->setThumbnail(rotatedThumbnail);
+
+    return true;
 }
 
 void View::onModelPagesReordered(const std::vector<unsigned int>& positions)
 {
-    for (auto& pageWidget : m_pageWidgets) {
-        for (unsigned int position : positions) {
-            if (position == static_cast<unsigned>(pageWidget->get_index())) {
-                pageWidget->setSelected(true);
+    m_selection.select(positions);
+    notifySelectionChanged();
+}
 
-                break;
-            }
-        }
+void View::onModelPagesPermuted(const std::vector<unsigned int>& order)
+{
+    m_pendingSelection = m_selection;
+    m_pendingSelection->permute(order);
+}
+
+void View::onModelPagesRemoved(const std::vector<unsigned int>& indexes)
+{
+    m_pendingSelection = m_selection;
+    m_pendingSelection->remove(indexes);
+}
+
+void View::onModelPagesInserted(const std::vector<unsigned int>& positions)
+{
+    m_pendingSelection = m_selection;
+    m_pendingSelection->insert(positions);
+}
+
+bool View::onKeyPressed(GdkEventKey* event)
+{
+    auto focusedWidget = dynamic_cast<InteractivePageWidget*>(get_focus_child());
+
+    if (focusedWidget == nullptr || numberOfPages() == 0 || m_verticalAdjustment == nullptr)
+        return false;
+
+    const unsigned int position = focusedWidget->position();
+    const unsigned int lastPosition = numberOfPages() - 1;
+    const auto rowsPerScreen = static_cast<unsigned int>(
+        std::max(1.0, m_verticalAdjustment->get_page_size() / rowHeight()));
+    const unsigned int pagesPerScreen = rowsPerScreen * m_columns;
+    std::optional<unsigned int> target;
+
+    switch (event->keyval) {
+    case GDK_KEY_Left:
+    case GDK_KEY_KP_Left:
+    case GDK_KEY_ISO_Left_Tab:
+        if (position > 0)
+            target = position - 1;
+        break;
+    case GDK_KEY_Right:
+    case GDK_KEY_KP_Right:
+    case GDK_KEY_Tab:
+        if (position < lastPosition)
+            target = position + 1;
+        break;
+    case GDK_KEY_Up:
+    case GDK_KEY_KP_Up:
+        if (position >= m_columns)
+            target = position - m_columns;
+        break;
+    case GDK_KEY_Down:
+    case GDK_KEY_KP_Down:
+        if (position + m_columns <= lastPosition)
+            target = position + m_columns;
+        break;
+    case GDK_KEY_Page_Up:
+    case GDK_KEY_KP_Page_Up:
+        target = position - std::min(position, pagesPerScreen);
+        break;
+    case GDK_KEY_Page_Down:
+    case GDK_KEY_KP_Page_Down:
+        target = std::min(lastPosition, position + pagesPerScreen);
+        break;
+    case GDK_KEY_Home:
+    case GDK_KEY_KP_Home:
+        target = 0;
+        break;
+    case GDK_KEY_End:
+    case GDK_KEY_KP_End:
+        target = lastPosition;
+        break;
+    default:
+        break;
     }
 
-    selectedPagesChanged.emit();
+    // At the edges of the grid, the focus may leave the view
+    if (!target.has_value())
+        return false;
+
+    focusPage(*target);
+
+    return true;
+}
+
+void View::focusPage(unsigned int position)
+{
+    // The row of the page is scrolled into view first, so that it stays bound
+    const double rowTop = static_cast<double>(position / m_columns) * rowHeight();
+    const double rowBottom = rowTop + rowHeight();
+    const double visibleTop = m_verticalAdjustment->get_value();
+    const double visibleBottom = visibleTop + m_verticalAdjustment->get_page_size();
+
+    if (rowTop < visibleTop)
+        m_verticalAdjustment->set_value(rowTop);
+    else if (rowBottom > visibleBottom)
+        m_verticalAdjustment->set_value(rowBottom - m_verticalAdjustment->get_page_size());
+
+    auto it = m_boundWidgets.find(position);
+    std::shared_ptr<InteractivePageWidget> pageWidget = it != m_boundWidgets.end()
+                                                            ? it->second
+                                                            : bindPageWidget(position);
+    pageWidget->grab_focus();
 }
 
 void View::onPageSelection(InteractivePageWidget* pageWidget)
 {
+    const unsigned int position = pageWidget->position();
+    m_selection.set(position, pageWidget->getSelected());
+
     if (pageWidget->getSelected())
-        m_lastPageSelected = pageWidget;
+        m_lastPageSelected = position;
     else
-        m_lastPageSelected = nullptr;
+        m_lastPageSelected.reset();
 
-    selectedPagesChanged.emit();
+    notifySelectionChanged();
 }
 
 void View::onShiftSelection(InteractivePageWidget* pageWidget)
 {
-    if (m_lastPageSelected == nullptr) {
-        m_lastPageSelected = pageWidget;
+    const unsigned int position = pageWidget->position();
+
+    if (!m_lastPageSelected.has_value()) {
+        m_selection.set(position, true);
+        m_lastPageSelected = position;
     }
     else {
-        int first = m_lastPageSelected->get_index();
-        int last = pageWidget->get_index();
+        const unsigned int first = std::min(*m_lastPageSelected, position);
+        const unsigned int last = std::max(*m_lastPageSelected, position);
 
-        if (first != -1 && last != -1) {
-            for (auto& widget : m_pageWidgets)
-                widget->setSelected(false);
-
-            if (first > last)
-                std::swap(first, last);
-
-            for (auto& widget : m_pageWidgets | rsv::drop(first) | rsv::take(last - first + 1))
-                widget->setSelected(true);
-        }
+        m_selection.clear();
+        m_selection.select(first, last);
     }
 
-    selectedPagesChanged.emit();
+    notifySelectionChanged();
 }
 
 void View::onPreviewRequested(const Glib::RefPtr<const Page>& page)
@@ -18,19 +18,26 @@
 #define SLICERVIEW_HPP
 
 #include <document.hpp>
+#include <pageselection.hpp>
+#include <thumbnailcache.hpp>
 #include "interactivepagewidget.hpp"
 #include "taskrunner.hpp"
-#include <queue>
+#include <chrono>
+#include <map>
+#include <optional>
 #include <glibmm/dispatcher.h>
-#include <gtkmm/eventbox.h>
-#include <gtkmm/flowbox.h>
+#include <gtkmm/adjustment.h>
+#include <gtkmm/layout.h>
 
 namespace Slicer {
 
-class View : public Gtk::EventBox {
+// Shows the pages of the document in a grid. Only the rows near the visible
+// area have widgets, which are recycled for other pages while scrolling.
+class View : public Gtk::Layout {
 
 public:
     View(TaskRunner& taskRunner,
+         ThumbnailCache& thumbnailCache,
          const std::function<void()>& onMouseWheelUp,
          const std::function<void()>& onMouseWheelDown);
 
@@ -42,6 +49,12 @@ public:
     ~View() override;
 
     void setDocument(Document& document, int targetWidgetSize);
+    void setVerticalAdjustment(const Glib::RefPtr<Gtk::Adjustment>& adjustment);
+    void setPrefetchMargin(double screens);
+    // Visible pages are also rendered at these sizes in the background, into the thumbnail cache
+    void setSpeculativePageSizes(const std::vector<int>& sizes);
+    // Drops the thumbnails of all pages outside of the visible area
+    void dropOffscreenThumbnails();
     void changePageSize(int targetWidgetSize);
     void setShowFileNames(bool showFileNames);
     void selectPageRange(unsigned int first, unsigned int last);
@@ -51,39 +64,119 @@ public:
     void clearSelection();
     void invertSelection();
 
+    const PageSelection& selection() const;
     unsigned int getSelectedChildIndex() const;
     std::vector<unsigned int> getSelectedChildrenIndexes() const;
     std::vector<unsigned int> getUnselectedChildrenIndexes() const;
 
     sigc::signal<void> selectedPagesChanged;
 
+    // Selection changes made while a batch is alive, as by the several document
+    // signals of one command, reach the widgets and the observers once, when the
+    // outermost batch ends
+    class SelectionBatch {
+    public:
+        explicit SelectionBatch(View& view);
+
+        SelectionBatch(const SelectionBatch&) = delete;
+        SelectionBatch& operator=(const SelectionBatch&) = delete;
+        SelectionBatch(SelectionBatch&&) = delete;
+        SelectionBatch& operator=(SelectionBatch&& src) = delete;
+
+        ~SelectionBatch();
+
+    private:
+        View& m_view;
+    };
+
 private:
-    Gtk::FlowBox m_flowBox;
-    std::list<std::shared_ptr<InteractivePageWidget>> m_pageWidgets;
+    // Rows of the grid, both ends included
+    struct RowRange {
+        unsigned int first;
+        unsigned int last;
+    };
+
+    // Widgets of the pages near the visible area, by position in the document
+    std::map<unsigned int, std::shared_ptr<InteractivePageWidget>> m_boundWidgets;
+    // Hidden widgets, waiting to be bound to another page
+    std::vector<std::shared_ptr<InteractivePageWidget>> m_recycledWidgets;
+    PageSelection m_selection;
     int m_pageWidgetSize = 0;
+    int m_labelsHeight = -1; // Measured on the first widget
+    unsigned int m_columns = 1;
+    static constexpr int cellMargin = 10; // At each side of a page widget
+    static constexpr int rowSpacing = 5;
     bool m_showFileNames = false;
     Document* m_document = nullptr;
     std::vector<sigc::connection> m_documentConnections;
     TaskRunner& m_taskRunner;
-
-    InteractivePageWidget* m_lastPageSelected = nullptr;
+    ThumbnailCache& m_thumbnailCache;
+
+    // Only pages near the visible area get rendered
+    Glib::RefPtr<Gtk::Adjustment> m_verticalAdjustment;
+    std::vector<sigc::connection> m_adjustmentConnections;
+    sigc::connection m_renderNearViewportConnection;
+    double m_prefetchMargin = 1.0; // In screens, above and below the visible area
+    // Time spent creating and binding widgets of the prefetch rows in one main loop iteration.
+    // Visible rows are always bound at once.
+    static constexpr std::chrono::milliseconds bindingBudget{8};
+
+    // Renders of the visible pages at other sizes, for the next zoom change
+    std::vector<int> m_speculativePageSizes;
+    std::vector<const Page*> m_speculativelyRenderedPages;
+    std::vector<std::weak_ptr<Task>> m_speculativeTasks;
+    static constexpr std::size_t speculativeCacheShare = 4; // At most a quarter of the cache
+
+    std::optional<unsigned int> m_lastPageSelected;
+    // Selection for the next change of the pages, worked out from the signal that
+    // announced it, since the change itself may replace a whole span of pages
+    std::optional<PageSelection> m_pendingSelection;
+    unsigned int m_selectionBatchDepth = 0;
+    bool m_isSelectionChanged = false;
 
     std::shared_ptr<InteractivePageWidget> createPageWidget(const Glib::RefPtr<const Page>& page);
-
-    void setupFlowbox();
+    std::shared_ptr<InteractivePageWidget> bindPageWidget(unsigned int position);
+    void recyclePageWidget(const std::shared_ptr<InteractivePageWidget>& pageWidget);
+    void recycleAllPageWidgets();
+    void placePageWidget(InteractivePageWidget& pageWidget);
+    void updateLayout();
+    // Returns false when some pages near the viewport are still without a widget
+    bool updateBoundWidgets();
+    void bindRow(unsigned int row);
+    void updateSelectedWidgets();
+    void notifySelectionChanged();
+    int labelsHeight();
+    int cellWidth() const;
+    int rowHeight();
+    RowRange rowsBetween(double top, double bottom);
+    unsigned int numberOfPages() const;
+
+    void setupLayout();
     void setupSignalHandlers(const std::function<void()>& onMouseWheelUp,
                              const std::function<void()>& onMouseWheelDown);
     void onModelItemsChanged(guint position, guint removed, guint added);
     void onModelPagesRotated(const std::vector<unsigned int>& positions);
     void onModelPagesReordered(const std::vector<unsigned int>& positions);
+    void onModelPagesPermuted(const std::vector<unsigned int>& order);
+    void onModelPagesRemoved(const std::vector<unsigned int>& indexes);
+    void onModelPagesInserted(const std::vector<unsigned int>& positions);
+    // Moves the focus by position, since only pages near the viewport have a widget to move it to
+    bool onKeyPressed(GdkEventKey* event);
+    void focusPage(unsigned int position);
     void onPageSelection(InteractivePageWidget* pageWidget);
     void onShiftSelection(InteractivePageWidget* pageWidget);
     void onPreviewRequested(const Glib::RefPtr<const Page>& page);
-    void renderPage(const std::shared_ptr<InteractivePageWidget>& pageWidget);
+    void renderPage(const std::shared_ptr<InteractivePageWidget>& pageWidget,
+                    TaskRunner::Priority priority);
+    void renderDraft(const std::shared_ptr<InteractivePageWidget>& pageWidget);
+    bool rotateThumbnail(const std::shared_ptr<InteractivePageWidget>& pageWidget);
+    void queueRenderPagesNearViewport();
+    // An idle handler, which runs again until all pages near the viewport have a widget
+    bool renderPagesNearViewport();
+    void renderSpeculatively(const std::vector<std::shared_ptr<InteractivePageWidget>>& visibleWidgets);
+    void cancelSpeculativeRendering();
     void cancelRenderingTasks();
     void clearState();
-
-    static int sortFunction(Gtk::FlowBoxChild* a, Gtk::FlowBoxChild* b);
 };
 }
 
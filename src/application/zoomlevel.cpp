@@ -58,6 +58,20 @@ int ZoomLevel::maxLevel() const
     return m_levels.back();
 }
 
+std::vector<int> ZoomLevel::neighbouringLevels() const
+{
+    const unsigned int index = m_zoomLevelIndex.get_value();
+    std::vector<int> levels;
+
+    if (index > 0)
+        levels.push_back(m_levels.at(index - 1));
+
+    if (index + 1 < m_levels.size())
+        levels.push_back(m_levels.at(index + 1));
+
+    return levels;
+}
+
 int ZoomLevel::operator++()
 {
     if (currentLevel() != maxLevel())
@@ -34,6 +34,9 @@ public:
 	int minLevel() const;
 	int maxLevel() const;
 
+	// The levels right below and above the current one, where they exist
+	std::vector<int> neighbouringLevels() const;
+
 	int operator++();
 	int operator--();
 
@@ -15,6 +15,8 @@
 // along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "command.hpp"
+#include <algorithm>
+#include <numeric>
 
 namespace Slicer {
 
@@ -184,6 +186,133 @@ void MovePageRangeCommand::redo()
     execute();
 }
 
+PermutePagesCommand::PermutePagesCommand(Document& document,
+                                         const std::vector<unsigned int>& order)
+    : m_document{document}
+    , m_order{order}
+    , m_inverseOrder{inverse(order)}
+{
+}
+
+void PermutePagesCommand::execute()
+{
+    m_document.permutePages(m_order);
+}
+
+void PermutePagesCommand::undo()
+{
+    m_document.permutePages(m_inverseOrder);
+}
+
+void PermutePagesCommand::redo()
+{
+    execute();
+}
+
+std::vector<unsigned int> PermutePagesCommand::inverse(const std::vector<unsigned int>& order)
+{
+    std::vector<unsigned int> inverseOrder(order.size());
+
+    for (unsigned int i = 0; i < order.size(); ++i)
+        inverseOrder.at(order.at(i)) = i;
+
+    return inverseOrder;
+}
+
+ReversePagesCommand::ReversePagesCommand(Document& document)
+    : PermutePagesCommand{document, reversedOrder(document)}
+{
+}
+
+std::vector<unsigned int> ReversePagesCommand::reversedOrder(const Document& document)
+{
+    std::vector<unsigned int> order(document.numberOfPages());
+    std::iota(order.rbegin(), order.rend(), 0);
+
+    return order;
+}
+
+SortPagesBySourceCommand::SortPagesBySourceCommand(Document& document)
+    : PermutePagesCommand{document, sourceOrder(document)}
+{
+}
+
+std::vector<unsigned int> SortPagesBySourceCommand::sourceOrder(const Document& document)
+{
+    std::vector<Glib::RefPtr<Page>> pages;
+
+    for (unsigned int i = 0; i < document.numberOfPages(); ++i)
+        pages.push_back(document.getPage(i));
+
+    std::vector<unsigned int> order(pages.size());
+    std::iota(order.begin(), order.end(), 0);
+
+    std::stable_sort(order.begin(), order.end(), [&pages](unsigned int a, unsigned int b) {
+        const Glib::RefPtr<Page>& pageA = pages.at(a);
+        const Glib::RefPtr<Page>& pageB = pages.at(b);
+
+        if (pageA->m_fileNumber != pageB->m_fileNumber)
+            return pageA->m_fileNumber < pageB->m_fileNumber;
+
+        return pageA->indexInFile() < pageB->indexInFile();
+    });
+
+    return order;
+}
+
+InterleavePagesCommand::InterleavePagesCommand(Document& document,
+                                               unsigned int firstFile,
+                                               unsigned int secondFile,
+                                               bool reverseSecondFile)
+    : PermutePagesCommand{document, interleavedOrder(document, firstFile, secondFile, reverseSecondFile)}
+{
+}
+
+std::vector<unsigned int> InterleavePagesCommand::interleavedOrder(const Document& document,
+                                                                   unsigned int firstFile,
+                                                                   unsigned int secondFile,
+                                                                   bool reverseSecondFile)
+{
+    if (firstFile == secondFile)
+        throw std::runtime_error("Pages must be interleaved from two different files");
+
+    std::vector<unsigned int> order(document.numberOfPages());
+    std::iota(order.begin(), order.end(), 0);
+
+    std::vector<unsigned int> firstPages;
+    std::vector<unsigned int> secondPages;
+    std::vector<unsigned int> places;
+
+    for (unsigned int i = 0; i < document.numberOfPages(); ++i) {
+        const unsigned int fileNumber = document.getPage(i)->m_fileNumber;
+
+        if (fileNumber == firstFile)
+            firstPages.push_back(i);
+        else if (fileNumber == secondFile)
+            secondPages.push_back(i);
+        else
+            continue;
+
+        places.push_back(i);
+    }
+
+    if (reverseSecondFile)
+        std::reverse(secondPages.begin(), secondPages.end());
+
+    // If a file has more pages, the rest of them go at the end
+    auto place = places.begin();
+
+    for (unsigned int i = 0; i < std::max(firstPages.size(), secondPages.size()); ++i) {
+        if (i < firstPages.size())
+            order.at(*place++) = firstPages.at(i);
+
+        if (i < secondPages.size())
+            order.at(*place++) = secondPages.at(i);
+    }
+
+    return order;
+}
+
 AddFilesCommand::AddFilesCommand(Document& document,
                                  const std::vector<Glib::RefPtr<Gio::File>>& files,
                                  unsigned int position)
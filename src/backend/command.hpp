@@ -145,6 +145,58 @@ private:
     const unsigned int m_indexDestination;
 };
 
+// Reorders the pages in a single pass, and restores their order on undo
+class PermutePagesCommand : public Command {
+public:
+    PermutePagesCommand(Document& document,
+                        const std::vector<unsigned int>& order);
+
+    void execute() override;
+    void undo() override;
+    void redo() override;
+
+private:
+    Document& m_document;
+    const std::vector<unsigned int> m_order;
+    const std::vector<unsigned int> m_inverseOrder;
+
+    static std::vector<unsigned int> inverse(const std::vector<unsigned int>& order);
+};
+
+class ReversePagesCommand : public PermutePagesCommand {
+public:
+    explicit ReversePagesCommand(Document& document);
+
+private:
+    static std::vector<unsigned int> reversedOrder(const Document& document);
+};
+
+// Puts the pages back in the order of the files they come from
+class SortPagesBySourceCommand : public PermutePagesCommand {
+public:
+    explicit SortPagesBySourceCommand(Document& document);
+
+private:
+    static std::vector<unsigned int> sourceOrder(const Document& document);
+};
+
+// Collates duplex scans: each page of the first file is followed by a page of
+// the second one, which is taken back to front if the backs were scanned that way.
+// The pages of both files take the places they had, and other pages don't move.
+class InterleavePagesCommand : public PermutePagesCommand {
+public:
+    InterleavePagesCommand(Document& document,
+                           unsigned int firstFile,
+                           unsigned int secondFile,
+                           bool reverseSecondFile);
+
+private:
+    static std::vector<unsigned int> interleavedOrder(const Document& document,
+                                                      unsigned int firstFile,
+                                                      unsigned int secondFile,
+                                                      bool reverseSecondFile);
+};
+
 class AddFilesCommand : public Command {
 public:
     AddFilesCommand(Document& document,
@@ -49,6 +49,12 @@ std::string getTempDirPath()
                                 APPLICATION_ID);
 }
 
+std::string getCacheDirPath()
+{
+    return Glib::build_filename(Glib::get_user_cache_dir(),
+                                APPLICATION_ID);
+}
+
 void createSlicerDirsIfNotExistent()
 {
     try {
@@ -0,0 +1,206 @@
+// PDF Slicer
+// Copyright (C) 2019 Julián Unrrein
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "diskthumbnailcache.hpp"
+#include <giomm/file.h>
+#include <glib/gstdio.h>
+#include <glibmm/miscutils.h>
+#include <glibmm/stringutils.h>
+#include <algorithm>
+#include <tuple>
+#include <vector>
+
+namespace Slicer {
+
+DiskThumbnailCache::DiskThumbnailCache(const std::string& directoryPath, std::uint64_t byteBudget)
+    : m_directoryPath{directoryPath}
+    , m_byteBudget{byteBudget}
+{
+}
+
+Glib::RefPtr<Gdk::Pixbuf> DiskThumbnailCache::load(const std::string& fileIdentity,
+                                                   const std::string& entryName)
+{
+    const std::string path = entryPath(fileIdentity, entryName);
+
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        loadIndexIfNeeded();
+
+        auto it = m_index.find(path);
+
+        if (it == m_index.end())
+            return {};
+
+        m_usageList.splice(m_usageList.begin(), m_usageList, it->second.positionInUsageList);
+    }
+
+    try {
+        Glib::RefPtr<Gdk::Pixbuf> thumbnail = Gdk::Pixbuf::create_from_file(path);
+
+        // The modification time doubles as the last usage time,
+        // so the eviction order is kept between sessions
+        g_utime(path.c_str(), nullptr);
+
+        return thumbnail;
+    }
+    catch (const Glib::Error&) {
+        // The file was deleted or corrupted behind our back
+        std::lock_guard<std::mutex> lock{m_mutex};
+        removeFromIndex(path);
+        g_remove(path.c_str());
+
+        return {};
+    }
+}
+
+void DiskThumbnailCache::store(const std::string& fileIdentity,
+                               const std::string& entryName,
+                               const Glib::RefPtr<Gdk::Pixbuf>& thumbnail)
+{
+    const std::string path = entryPath(fileIdentity, entryName);
+    gchar* buffer = nullptr;
+    gsize bufferSize = 0;
+
+    try {
+        // Low compression keeps both encoding and decoding fast
+        thumbnail->save_to_buffer(buffer, bufferSize, "png", {"compression"}, {"1"});
+
+        if (bufferSize > m_byteBudget) {
+            g_free(buffer);
+            return;
+        }
+
+        g_mkdir_with_parents(Glib::build_filename(m_directoryPath, fileIdentity).c_str(), 0700);
+
+        // Contents are replaced atomically, so a concurrent load never sees a partial file
+        std::string newEtag;
+        Gio::File::create_for_path(path)->replace_contents(buffer,
+                                                           bufferSize,
+                                                           "",
+                                                           newEtag,
+                                                           false,
+                                                           Gio::FILE_CREATE_REPLACE_DESTINATION);
+        g_free(buffer);
+    }
+    catch (const Glib::Error&) {
+        g_free(buffer);
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock{m_mutex};
+    loadIndexIfNeeded();
+    addToIndex(path, bufferSize);
+    evictUntilWithinBudget();
+}
+
+std::uint64_t DiskThumbnailCache::usedBytes()
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    loadIndexIfNeeded();
+
+    return m_usedBytes;
+}
+
+std::string DiskThumbnailCache::entryPath(const std::string& fileIdentity,
+                                          const std::string& entryName) const
+{
+    return Glib::build_filename(m_directoryPath, fileIdentity, entryName + ".png");
+}
+
+void DiskThumbnailCache::loadIndexIfNeeded()
+{
+    if (m_isIndexLoaded)
+        return;
+
+    m_isIndexLoaded = true;
+
+    // Scanning is deferred until the first use, so it happens in a rendering
+    // thread instead of slowing down the application startup
+    std::vector<std::tuple<guint64, std::string, std::uint64_t>> entries;
+
+    try {
+        auto directory = Gio::File::create_for_path(m_directoryPath);
+        auto fileDirectories = directory->enumerate_children("standard::name,standard::type");
+
+        while (Glib::RefPtr<Gio::FileInfo> fileDirectoryInfo = fileDirectories->next_file()) {
+            if (fileDirectoryInfo->get_file_type() != Gio::FILE_TYPE_DIRECTORY)
+                continue;
+
+            auto fileDirectory = directory->get_child(fileDirectoryInfo->get_name());
+            auto children = fileDirectory->enumerate_children("standard::name,standard::size,time::modified");
+
+            while (Glib::RefPtr<Gio::FileInfo> info = children->next_file()) {
+                const std::string name = info->get_name();
+
+                if (!Glib::str_has_suffix(name, ".png"))
+                    continue;
+
+                entries.emplace_back(info->get_attribute_uint64(G_FILE_ATTRIBUTE_TIME_MODIFIED),
+                                     fileDirectory->get_child(name)->get_path(),
+                                     static_cast<std::uint64_t>(info->get_size()));
+            }
+        }
+    }
+    catch (const Glib::Error&) {
+        // There's no cache directory yet
+    }
+
+    // Oldest first, so the most recently used end up at the front of the list
+    std::sort(entries.begin(), entries.end());
+
+    for (const auto& [modificationTime, path, size] : entries)
+        addToIndex(path, size);
+
+    evictUntilWithinBudget();
+}
+
+void DiskThumbnailCache::addToIndex(const std::string& path, std::uint64_t size)
+{
+    removeFromIndex(path);
+
+    m_usageList.push_front(path);
+    m_index.emplace(path, EntryData{m_usageList.begin(), size});
+    m_usedBytes += size;
+}
+
+void DiskThumbnailCache::removeFromIndex(const std::string& path)
+{
+    auto it = m_index.find(path);
+
+    if (it == m_index.end())
+        return;
+
+    m_usedBytes -= it->second.size;
+    m_usageList.erase(it->second.positionInUsageList);
+    m_index.erase(it);
+}
+
+void DiskThumbnailCache::evictUntilWithinBudget()
+{
+    while (m_usedBytes > m_byteBudget) {
+        const std::string path = m_usageList.back();
+
+        removeFromIndex(path);
+        g_remove(path.c_str());
+
+        // Only succeeds once the last thumbnail of its file is gone. A store racing with it
+        // fails to write its thumbnail, which is then rendered again when needed.
+        g_rmdir(Glib::path_get_dirname(path).c_str());
+    }
+}
+
+} // namespace Slicer
@@ -0,0 +1,74 @@
+// PDF Slicer
+// Copyright (C) 2019 Julián Unrrein
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef DISKTHUMBNAILCACHE_HPP
+#define DISKTHUMBNAILCACHE_HPP
+
+#include <gdkmm/pixbuf.h>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+namespace Slicer {
+
+// Persists rendered thumbnails as PNG files, so they survive between sessions.
+// Entries are named after a hash of the path, size and modification time of their
+// source file, which means that a modified file never hits thumbnails of its old contents.
+// When the files exceed the byte budget, the least recently used are deleted.
+class DiskThumbnailCache {
+public:
+    DiskThumbnailCache(const std::string& directoryPath, std::uint64_t byteBudget);
+
+    DiskThumbnailCache(const DiskThumbnailCache&) = delete;
+    DiskThumbnailCache& operator=(const DiskThumbnailCache&) = delete;
+    DiskThumbnailCache(DiskThumbnailCache&&) = delete;
+    DiskThumbnailCache& operator=(DiskThumbnailCache&& src) = delete;
+
+    ~DiskThumbnailCache() = default;
+
+    // Returns an empty RefPtr if the thumbnail isn't cached
+    Glib::RefPtr<Gdk::Pixbuf> load(const std::string& fileIdentity, const std::string& entryName);
+    void store(const std::string& fileIdentity,
+               const std::string& entryName,
+               const Glib::RefPtr<Gdk::Pixbuf>& thumbnail);
+
+    std::uint64_t usedBytes();
+
+private:
+    struct EntryData {
+        std::list<std::string>::iterator positionInUsageList;
+        std::uint64_t size;
+    };
+
+    const std::string m_directoryPath;
+    const std::uint64_t m_byteBudget;
+    std::uint64_t m_usedBytes = 0;
+    bool m_isIndexLoaded = false;
+    std::list<std::string> m_usageList; // Paths, most recently used first
+    std::unordered_map<std::string, EntryData> m_index;
+    std::mutex m_mutex;
+
+    std::string entryPath(const std::string& fileIdentity, const std::string& entryName) const;
+    void loadIndexIfNeeded();
+    void addToIndex(const std::string& path, std::uint64_t size);
+    void removeFromIndex(const std::string& path);
+    void evictUntilWithinBudget();
+};
+
+} // namespace Slicer
+
+#endif // DISKTHUMBNAILCACHE_HPP
@@ -15,10 +15,13 @@
 // along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "document.hpp"
+#include "pagerenderer.hpp"
 #include "tempfile.hpp"
+#include <giomm/fileinfo.h>
+#include <glibmm/checksum.h>
 #include <glibmm/convert.h>
+#include <algorithm>
 #include <numeric>
-#include <range/v3/view/enumerate.hpp>
 
 namespace Slicer {
 
@@ -26,7 +29,7 @@ Document::Document(const Glib::RefPtr<Gio::File>& sourceFile)
     : m_pages{Gio::ListStore<Page>::create()}
 {
     FileData fileData = loadFile(sourceFile);
-    m_pages->splice(0, 0, loadPages(fileData, 0));
+    insertPageRange(loadPages(fileData, 0), 0);
 
     m_filesData.emplace_back(std::move(fileData));
 }
@@ -38,38 +41,58 @@ Document::Document(const std::vector<Glib::RefPtr<Gio::File>>& sourceFiles) : Do
     addFiles(additional_files, m_pages->get_n_items());
 }
 
+Document::~Document()
+{
+    // Pages may outlive the document, in commands or widgets
+    for (unsigned int i = 0; i < numberOfPages(); ++i)
+        m_pages->get_item(i)->m_document = nullptr;
+
+    // Rendering threads would otherwise keep the files of this document open
+    // until memory runs low, since their paths are never rendered again
+    for (const FileData& fileData : m_filesData)
+        PageRenderer::releaseDocuments(fileData.tempFile->get_path());
+}
+
 Glib::RefPtr<Page> Document::removePage(unsigned int index)
 {
     Glib::RefPtr<Page> removedPage = m_pages->get_item(index);
     m_pages->remove(index);
-
-    for (unsigned int i = index; i < numberOfPages(); ++i)
-        m_pages->get_item(i)->setDocumentIndex(i);
+    releasePage(removedPage, index);
+    invalidateDocumentIndexes(index);
 
     return removedPage;
 }
 
 std::vector<Glib::RefPtr<Page>> Document::removePages(const std::vector<unsigned int>& indexes)
 {
+    if (indexes.empty())
+        return {};
+
+    const unsigned int first = indexes.front();
+    const unsigned int last = indexes.back();
     std::vector<Glib::RefPtr<Page>> removedPages;
+    std::vector<Glib::RefPtr<Page>> keptPages;
+    auto nextRemoved = indexes.begin();
 
-    for (unsigned int position : indexes) {
-        auto page = m_pages->get_item(position);
-        removedPages.push_back(page);
-    }
+    for (unsigned int i = first; i <= last; ++i) {
+        Glib::RefPtr<Page> page = m_pages->get_item(i);
 
-    // Removing disjoint pages is complicated.
-    // The list positions are the positions in the list of the pages we
-    // want to remove.
-    // The problem is that, everytime a page is removed, all positions are invalidated.
-    // After each page removal, the remaining positions must be decremented by one.
-    for (unsigned int i = 0; i < indexes.size(); ++i) {
-        const unsigned int actualPosition = indexes.at(i) - i;
-        m_pages->remove(actualPosition);
+        if (nextRemoved != indexes.end() && *nextRemoved == i) {
+            releasePage(page, i);
+            removedPages.push_back(page);
+            ++nextRemoved;
+        }
+        else {
+            keptPages.push_back(page);
+        }
     }
 
-    for (unsigned int i = indexes.front(); i < numberOfPages(); ++i)
-        m_pages->get_item(i)->setDocumentIndex(i);
+    // Removing the pages one by one would shift the rest of the list, and notify
+    // a change, for each of them. Instead, the pages between the first and the
+    // last removed ones are replaced with the ones to keep, in a single splice.
+    pagesRemoved.emit(indexes);
+    m_pages->splice(first, last - first + 1, keptPages);
+    invalidateDocumentIndexes(first);
 
     return removedPages;
 }
@@ -78,30 +101,80 @@ std::vector<Glib::RefPtr<Page>> Document::removePageRange(unsigned int first, un
 {
     std::vector<Glib::RefPtr<Page>> removedPages;
 
-    for (unsigned int i = first; i <= last; ++i)
-        removedPages.push_back(m_pages->get_item(i));
+    for (unsigned int i = first; i <= last; ++i) {
+        Glib::RefPtr<Page> page = m_pages->get_item(i);
+        releasePage(page, i);
+        removedPages.push_back(page);
+    }
 
     const unsigned int nElem = last - first + 1;
     m_pages->splice(first, nElem, {});
-
-    for (unsigned int i = first; i < numberOfPages(); ++i)
-        m_pages->get_item(i)->setDocumentIndex(i);
+    invalidateDocumentIndexes(first);
 
     return removedPages;
 }
 
 void Document::insertPage(const Glib::RefPtr<Page>& page)
 {
-    for (unsigned int i = page->getDocumentIndex(); i < numberOfPages(); ++i)
-        m_pages->get_item(i)->setDocumentIndex(i + 1);
+    // Back where it was when it was removed
+    const unsigned int position = std::min(page->getDocumentIndex(), numberOfPages());
 
-    m_pages->insert_sorted(page, pageComparator{});
+    adoptPage(page);
+    m_pages->insert(position, page);
+    invalidateDocumentIndexes(position);
 }
 
 void Document::insertPages(const std::vector<Glib::RefPtr<Page>>& pages)
 {
+    if (pages.empty())
+        return;
+
+    // Each page goes back to the position it had when it was removed
+    std::vector<std::pair<unsigned int, Glib::RefPtr<Page>>> insertedPages;
+
     for (const auto& page : pages)
-        insertPage(page);
+        insertedPages.emplace_back(page->getDocumentIndex(), page);
+
+    std::sort(insertedPages.begin(), insertedPages.end(), [](const auto& a, const auto& b) {
+        return a.first < b.first;
+    });
+
+    for (unsigned int i = 1; i < insertedPages.size(); ++i) {
+        if (insertedPages.at(i).first == insertedPages.at(i - 1).first)
+            throw std::runtime_error("Two pages can't be inserted at the same position");
+    }
+
+    if (insertedPages.back().first >= numberOfPages() + insertedPages.size())
+        throw std::runtime_error("The insertion position is greater than the number of pages");
+
+    const unsigned int first = insertedPages.front().first;
+    const unsigned int last = insertedPages.back().first;
+    std::vector<unsigned int> positions;
+
+    for (const auto& [position, page] : insertedPages)
+        positions.push_back(position);
+
+    // Merge them with the pages that end up in between, so that the whole
+    // span is replaced in a single splice
+    std::vector<Glib::RefPtr<Page>> mergedPages;
+    auto nextInserted = insertedPages.begin();
+    unsigned int nextKept = first;
+
+    for (unsigned int position = first; position <= last; ++position) {
+        if (nextInserted != insertedPages.end() && nextInserted->first == position) {
+            adoptPage(nextInserted->second);
+            mergedPages.push_back(nextInserted->second);
+            ++nextInserted;
+        }
+        else {
+            mergedPages.push_back(m_pages->get_item(nextKept));
+            ++nextKept;
+        }
+    }
+
+    pagesInserted.emit(positions);
+    m_pages->splice(first, nextKept - first, mergedPages);
+    invalidateDocumentIndexes(first);
 }
 
 void Document::insertPageRange(const std::vector<Glib::RefPtr<Page>>& pages, unsigned int position)
@@ -109,39 +182,88 @@ void Document::insertPageRange(const std::vector<Glib::RefPtr<Page>>& pages, uns
     if (position > numberOfPages())
         throw std::runtime_error("The insertion position is greater than the number of pages");
 
-    for (unsigned int i = position; i < numberOfPages(); ++i)
-        m_pages->get_item(i)->setDocumentIndex(i + static_cast<unsigned>(pages.size()));
+    for (const auto& page : pages)
+        adoptPage(page);
 
     m_pages->splice(position, 0, pages);
+    invalidateDocumentIndexes(position);
 }
 
 void Document::movePage(unsigned int indexToMove, unsigned int indexDestination)
 {
-    Glib::RefPtr<Page> pageToMove = removePage(indexToMove);
-    pageToMove->setDocumentIndex(indexDestination);
-    insertPage(pageToMove);
-
-    pagesReordered.emit({indexDestination});
+    movePageRange(indexToMove, indexToMove, indexDestination);
 }
 
 void Document::movePageRange(unsigned int indexFirst,
                              unsigned int indexLast,
                              unsigned int indexDestination)
 {
-    auto pagesToMove = removePageRange(indexFirst, indexLast);
+    const unsigned int numberOfMovedPages = indexLast - indexFirst + 1;
+
+    if (indexFirst > indexLast || indexLast >= numberOfPages()
+        || indexDestination + numberOfMovedPages > numberOfPages())
+        throw std::runtime_error("Incorrect parameters");
 
-    for (unsigned int i = 0; i < pagesToMove.size(); ++i)
-        pagesToMove.at(i)->setDocumentIndex(indexDestination + i);
+    // Only the pages between the old and the new place of the range change their
+    // position, so they are rotated in place and replaced with a single splice
+    const unsigned int windowFirst = std::min(indexFirst, indexDestination);
+    const unsigned int windowLast = std::max(indexLast, indexDestination + numberOfMovedPages - 1);
+    std::vector<Glib::RefPtr<Page>> window;
 
-    insertPageRange(pagesToMove, indexDestination);
+    for (unsigned int i = windowFirst; i <= windowLast; ++i)
+        window.push_back(m_pages->get_item(i));
 
-    const unsigned int numberOfPages = indexLast - indexFirst + 1;
-    std::vector<unsigned int> reorderedIndexes(numberOfPages);
+    if (indexDestination < indexFirst)
+        std::rotate(window.begin(), window.begin() + (indexFirst - windowFirst), window.end());
+    else
+        std::rotate(window.begin(), window.begin() + numberOfMovedPages, window.end());
+
+    m_pages->splice(windowFirst, static_cast<unsigned>(window.size()), window);
+    invalidateDocumentIndexes(windowFirst);
+
+    std::vector<unsigned int> reorderedIndexes(numberOfMovedPages);
     std::iota(reorderedIndexes.begin(), reorderedIndexes.end(), indexDestination);
 
     pagesReordered.emit(reorderedIndexes);
 }
 
+void Document::permutePages(const std::vector<unsigned int>& order)
+{
+    if (order.size() != numberOfPages())
+        throw std::runtime_error("The permutation doesn't cover every page");
+
+    std::vector<bool> isTaken(order.size(), false);
+
+    for (unsigned int index : order) {
+        if (index >= order.size() || isTaken.at(index))
+            throw std::runtime_error("The order is not a permutation of the pages");
+
+        isTaken.at(index) = true;
+    }
+
+    unsigned int first = 0;
+
+    while (first < order.size() && order.at(first) == first)
+        ++first;
+
+    if (first == order.size())
+        return;
+
+    unsigned int last = static_cast<unsigned>(order.size()) - 1;
+
+    while (order.at(last) == last)
+        --last;
+
+    std::vector<Glib::RefPtr<Page>> permutedPages;
+
+    for (unsigned int i = first; i <= last; ++i)
+        permutedPages.push_back(m_pages->get_item(order.at(i)));
+
+    pagesPermuted.emit(order);
+    m_pages->splice(first, last - first + 1, permutedPages);
+    invalidateDocumentIndexes(first);
+}
+
 void Document::rotatePagesRight(const std::vector<unsigned int>& pageNumbers)
 {
     for (unsigned int pageNumber : pageNumbers)
@@ -162,10 +284,6 @@ unsigned int Document::addFile(const Glib::RefPtr<Gio::File>& file, unsigned int
 {
     FileData fileData = loadFile(file);
     std::vector<Glib::RefPtr<Page>> pages = loadPages(fileData, m_filesData.size());
-
-    for (auto [i, page] : ranges::views::enumerate(pages))
-        page->setDocumentIndex(position + i);
-
     insertPageRange(pages, position);
     m_filesData.emplace_back(std::move(fileData));
 
@@ -223,6 +341,31 @@ PdfSaver::SaveData Document::getSaveData() const
     return result;
 }
 
+void Document::adoptPage(const Glib::RefPtr<Page>& page)
+{
+    page->m_document = this;
+}
+
+void Document::releasePage(const Glib::RefPtr<Page>& page, unsigned int index)
+{
+    // Removed pages remember their position, to be inserted back there
+    page->m_document = nullptr;
+    page->m_indexInDocument = index;
+}
+
+void Document::invalidateDocumentIndexes(unsigned int position)
+{
+    m_firstOutdatedIndex = std::min(m_firstOutdatedIndex, position);
+}
+
+void Document::updateDocumentIndexes() const
+{
+    for (unsigned int i = m_firstOutdatedIndex; i < numberOfPages(); ++i)
+        m_pages->get_item(i)->m_indexInDocument = i;
+
+    m_firstOutdatedIndex = numberOfPages();
+}
+
 Document::FileData Document::loadFile(const Glib::RefPtr<Gio::File>& sourceFile)
 {
     std::unique_ptr<poppler::document> tempDocument{poppler::document::load_from_file(sourceFile->get_path())};
@@ -237,13 +380,28 @@ Document::FileData Document::loadFile(const Glib::RefPtr<Gio::File>& sourceFile)
 
     return FileData{sourceFile,
                     tempFile,
+                    computeFileHash(sourceFile),
                     std::move(document)};
 }
 
+std::string Document::computeFileHash(const Glib::RefPtr<Gio::File>& file)
+{
+    Glib::RefPtr<Gio::FileInfo> info = file->query_info(G_FILE_ATTRIBUTE_STANDARD_SIZE ","
+                                                        G_FILE_ATTRIBUTE_TIME_MODIFIED ","
+                                                        G_FILE_ATTRIBUTE_TIME_MODIFIED_USEC);
+    const std::string identity = file->get_path() + '\n'
+                                 + std::to_string(info->get_size()) + '\n'
+                                 + std::to_string(info->get_attribute_uint64(G_FILE_ATTRIBUTE_TIME_MODIFIED)) + '.'
+                                 + std::to_string(info->get_attribute_uint32(G_FILE_ATTRIBUTE_TIME_MODIFIED_USEC));
+
+    return Glib::Checksum::compute_checksum(Glib::Checksum::CHECKSUM_SHA1, identity);
+}
+
 std::vector<Glib::RefPtr<Page>> Document::loadPages(const Document::FileData& fileData,
                                                     unsigned int fileNumber)
 {
     const Glib::ustring basename = Glib::filename_display_basename(fileData.originalFile->get_path());
+    const std::string tempFilePath = fileData.tempFile->get_path();
     std::vector<Glib::RefPtr<Page>> result;
 
     for (int i = 0; i < fileData.popplerDocument->pages(); ++i) {
@@ -252,7 +410,9 @@ std::vector<Glib::RefPtr<Page>> Document::loadPages(const Document::FileData& fi
         if (ppage == nullptr)
             throw std::runtime_error("Couldn't load page with number: " + std::to_string(i));
 
-        auto page = Glib::RefPtr<Page>{new Page{std::move(ppage),
+        auto page = Glib::RefPtr<Page>{new Page{*ppage,
+                                                tempFilePath,
+                                                fileData.fileHash,
                                                 basename,
                                                 fileNumber,
                                                 static_cast<unsigned>(i)}};
@@ -31,11 +31,21 @@ public:
     Document(const Glib::RefPtr<Gio::File>& sourceFile);
     Document(const std::vector<Glib::RefPtr<Gio::File>>& sourceFiles);
 
+    // Pages point back to their document
+    Document(const Document&) = delete;
+    Document& operator=(const Document&) = delete;
+    Document(Document&&) = delete;
+    Document& operator=(Document&& src) = delete;
+
+    ~Document();
+
     Glib::RefPtr<Page> removePage(unsigned int index);
+    // The indexes must be in ascending order
     std::vector<Glib::RefPtr<Page>> removePages(const std::vector<unsigned int>& indexes);
     std::vector<Glib::RefPtr<Page>> removePageRange(unsigned int first, unsigned int last);
 
     void insertPage(const Glib::RefPtr<Page>& page);
+    // Puts removed pages back where they were, in a single change
     void insertPages(const std::vector<Glib::RefPtr<Page>>& pages);
     void insertPageRange(const std::vector<Glib::RefPtr<Page>>& pages, unsigned int position);
 
@@ -44,6 +54,10 @@ public:
                        unsigned int indexLast,
                        unsigned int indexDestination);
 
+    // Puts at each position i the page that was at position order[i].
+    // Only the span of pages that change their position is replaced, in a single change.
+    void permutePages(const std::vector<unsigned int>& order);
+
     void rotatePagesRight(const std::vector<unsigned int>& pageNumbers);
     void rotatePagesLeft(const std::vector<unsigned int>& pageNumbers);
 
@@ -57,21 +71,43 @@ public:
 
     PdfSaver::SaveData getSaveData() const;
 
-    sigc::signal<void, std::vector<unsigned int>> pagesRotated;
-    sigc::signal<void, std::vector<unsigned int>> pagesReordered;
+    sigc::signal<void, const std::vector<unsigned int>&> pagesRotated;
+    sigc::signal<void, const std::vector<unsigned int>&> pagesReordered;
+    // Emitted right before the pages change, so that state kept by position can
+    // follow them, even if the change replaces a whole span of pages at once.
+    // They carry the order given to permutePages(), the indexes given to removePages(),
+    // and the positions, in ascending order, that the pages given to insertPages() take.
+    sigc::signal<void, const std::vector<unsigned int>&> pagesPermuted;
+    sigc::signal<void, const std::vector<unsigned int>&> pagesRemoved;
+    sigc::signal<void, const std::vector<unsigned int>&> pagesInserted;
 
 private:
+    friend class Page;
+
     struct FileData {
         Glib::RefPtr<Gio::File> originalFile;
         Glib::RefPtr<Gio::File> tempFile;
+        std::string fileHash;
         std::unique_ptr<poppler::document> popplerDocument;
     };
 
     static FileData loadFile(const Glib::RefPtr<Gio::File>& sourceFile);
+    // Identifies a file by its path, size and modification time, which is
+    // much cheaper than reading the whole file when it is opened
+    static std::string computeFileHash(const Glib::RefPtr<Gio::File>& file);
     static std::vector<Glib::RefPtr<Page>> loadPages(const FileData& fileData, unsigned int fileNumber);
 
     std::vector<FileData> m_filesData;
     Glib::RefPtr<Gio::ListStore<Page>> m_pages;
+
+    // Editing the document doesn't renumber the pages after the edit.
+    // From this position on, their indexes are updated when somebody asks for one.
+    mutable unsigned int m_firstOutdatedIndex = 0;
+
+    void adoptPage(const Glib::RefPtr<Page>& page);
+    void releasePage(const Glib::RefPtr<Page>& page, unsigned int index);
+    void invalidateDocumentIndexes(unsigned int position);
+    void updateDocumentIndexes() const;
 };
 }
 
@@ -15,21 +15,30 @@
 // along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "page.hpp"
+#include "document.hpp"
 #include <cmath>
 
 namespace Slicer {
 
-Page::Page(std::unique_ptr<poppler::page> ppage,
+Page::Page(const poppler::page& ppage,
+           const std::string& filePath,
+           const std::string& fileHash,
            const Glib::ustring& fileName,
            unsigned int fileNumber,
            unsigned int pageNumber)
     : m_fileNumber{fileNumber}
-    , m_ppage{std::move(ppage)}
+    , m_filePath{filePath}
+    , m_fileHash{fileHash}
     , m_fileName{fileName}
     , m_indexInFile{pageNumber}
     , m_indexInDocument{m_indexInFile}
 {
-    switch (m_ppage->orientation()) {
+    // The size is cached so rendering threads never have to query
+    // the poppler page owned by the main thread
+    const poppler::rectf rectangle = ppage.page_rect();
+    m_size = {static_cast<int>(rectangle.width()), static_cast<int>(rectangle.height())};
+
+    switch (ppage.orientation()) {
     case poppler::page::orientation_enum::portrait:
         m_sourceRotation = m_currentRotation = 0;
         break;
@@ -45,6 +54,16 @@ Page::Page(std::unique_ptr<poppler::page> ppage,
     }
 }
 
+const std::string& Page::filePath() const
+{
+    return m_filePath;
+}
+
+const std::string& Page::fileHash() const
+{
+    return m_fileHash;
+}
+
 const Glib::ustring& Page::fileName() const
 {
     return m_fileName;
@@ -57,21 +76,27 @@ unsigned int Page::indexInFile() const
 
 unsigned int Page::getDocumentIndex() const
 {
+    if (m_document != nullptr)
+        m_document->updateDocumentIndexes();
+
     return m_indexInDocument;
 }
 
 Page::Size Page::size() const
 {
-    poppler::rectf rectangle = m_ppage->page_rect();
-
-    return {static_cast<int>(rectangle.width()), static_cast<int>(rectangle.height())};
+    return m_size;
 }
 
 Page::Size Page::rotatedSize() const
+{
+    return rotatedSize(m_currentRotation);
+}
+
+Page::Size Page::rotatedSize(int rotation) const
 {
     Size size = this->size();
 
-    if (std::abs((m_currentRotation / 90) % 2) != 0)
+    if (std::abs((rotation / 90) % 2) != 0)
         std::swap(size.width, size.height);
 
     return size;
@@ -105,11 +130,9 @@ Page::Size Page::scaledRotatedSize(int targetSize) const
     return scaleSize(rotatedSize(), targetSize);
 }
 
-void Page::setDocumentIndex(unsigned int newIndex)
+Page::Size Page::scaledRotatedSize(int targetSize, int rotation) const
 {
-    m_indexInDocument = newIndex;
-
-    indexChanged.emit();
+    return scaleSize(rotatedSize(rotation), targetSize);
 }
 
 void Page::rotateRight()
@@ -128,30 +151,4 @@ void Page::rotateLeft()
         m_currentRotation -= 90;
 }
 
-int Page::sortFunction(const Page& a, const Page& b)
-{
-    const unsigned int aPosition = a.getDocumentIndex();
-    const unsigned int bPosition = b.getDocumentIndex();
-
-    if (aPosition < bPosition)
-        return -1;
-
-    if (aPosition == bPosition)
-        return 0;
-
-    return 1;
-}
-
-int Page::sortFunction(const Glib::RefPtr<const Page>& a,
-                       const Glib::RefPtr<const Page>& b)
-{
-    return sortFunction(*a.get(), *b.get());
-}
-
-int pageComparator::operator()(const Glib::RefPtr<const Page>& a,
-                               const Glib::RefPtr<const Page>& b)
-{
-    return Page::sortFunction(a, b);
-}
-
 } // namespace Slicer
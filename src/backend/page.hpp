@@ -23,6 +23,8 @@
 
 namespace Slicer {
 
+class Document;
+
 class Page : public Glib::Object {
 public:
     struct Size {
@@ -30,46 +32,46 @@ public:
         int height;
     };
 
-    Page(std::unique_ptr<poppler::page> ppage,
+    Page(const poppler::page& ppage,
+         const std::string& filePath,
+         const std::string& fileHash,
          const Glib::ustring& fileName,
          unsigned int fileNumber,
          unsigned int pageNumber);
 
+    const std::string& filePath() const;
+    const std::string& fileHash() const;
     const Glib::ustring& fileName() const;
     unsigned int indexInFile() const;
+    // Position in the document it belongs to, or that it had when it was removed
     unsigned int getDocumentIndex() const;
     int sourceRotation() const { return m_sourceRotation; }
     int currentRotation() const { return m_currentRotation; }
     Size size() const;
     Size rotatedSize() const;
+    Size rotatedSize(int rotation) const;
     Size scaledSize(int targetSize) const;
     Size scaledRotatedSize(int targetSize) const;
+    Size scaledRotatedSize(int targetSize, int rotation) const;
 
-    void setDocumentIndex(unsigned int newIndex);
     void rotateRight();
     void rotateLeft();
 
-    sigc::signal<void> indexChanged;
     const unsigned int m_fileNumber;
 
-    static int sortFunction(const Page& a, const Page& b);
-    static int sortFunction(const Glib::RefPtr<const Page>& a,
-                            const Glib::RefPtr<const Page>& b);
-
 private:
-    std::unique_ptr<poppler::page> m_ppage;
+    friend class Document;
+
+    const std::string m_filePath;
+    const std::string m_fileHash;
     const Glib::ustring m_fileName;
     const unsigned int m_indexInFile;
+    // Kept up to date lazily by the document, only when somebody asks for it
+    const Document* m_document = nullptr;
     unsigned int m_indexInDocument;
+    Size m_size;
     int m_sourceRotation;
     int m_currentRotation;
-
-    friend class PageRenderer; // For access to m_ppage
-};
-
-struct pageComparator {
-    int operator()(const Glib::RefPtr<const Page>& a,
-                   const Glib::RefPtr<const Page>& b);
 };
 
 } // namespace Slicer
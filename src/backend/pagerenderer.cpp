@@ -15,20 +15,95 @@
 // along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "pagerenderer.hpp"
-#include <cairomm/context.h>
+#include "pixeloperations.hpp"
+#include <algorithm>
+#include <poppler/cpp/poppler-document.h>
 #include <poppler/cpp/poppler-page-renderer.h>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace Slicer {
 
-PageRenderer::PageRenderer(const Glib::RefPtr<const Page>& page)
+// Each rendering thread opens its own instance of every document it renders,
+// so poppler state is never shared between threads. Other threads may only
+// drop them, which leaves a document being rendered open until the render ends.
+namespace {
+
+struct ThreadDocuments {
+    std::mutex mutex;
+    std::unordered_map<std::string, std::shared_ptr<poppler::document>> documents;
+
+    ThreadDocuments();
+    ~ThreadDocuments();
+};
+
+} // namespace
+
+// The documents of every rendering thread, so that they can be released from any thread
+static std::mutex registryMutex;
+static std::unordered_set<ThreadDocuments*> registry;
+
+ThreadDocuments::ThreadDocuments()
+{
+    std::lock_guard<std::mutex> lock{registryMutex};
+    registry.insert(this);
+}
+
+ThreadDocuments::~ThreadDocuments()
+{
+    std::lock_guard<std::mutex> lock{registryMutex};
+    registry.erase(this);
+}
+
+static std::shared_ptr<poppler::document> threadLocalDocument(const std::string& filePath)
+{
+    thread_local ThreadDocuments threadDocuments;
+    std::lock_guard<std::mutex> lock{threadDocuments.mutex};
+
+    std::shared_ptr<poppler::document>& document = threadDocuments.documents[filePath];
+
+    if (document == nullptr)
+        document.reset(poppler::document::load_from_file(filePath));
+
+    if (document == nullptr) {
+        threadDocuments.documents.erase(filePath);
+        throw std::runtime_error("Couldn't load file for rendering: " + filePath);
+    }
+
+    return document;
+}
+
+void PageRenderer::releaseDocuments()
+{
+    std::lock_guard<std::mutex> registryLock{registryMutex};
+
+    for (ThreadDocuments* threadDocuments : registry) {
+        std::lock_guard<std::mutex> lock{threadDocuments->mutex};
+        threadDocuments->documents.clear();
+    }
+}
+
+void PageRenderer::releaseDocuments(const std::string& filePath)
+{
+    std::lock_guard<std::mutex> registryLock{registryMutex};
+
+    for (ThreadDocuments* threadDocuments : registry) {
+        std::lock_guard<std::mutex> lock{threadDocuments->mutex};
+        threadDocuments->documents.erase(filePath);
+    }
+}
+
+PageRenderer::PageRenderer(const Glib::RefPtr<const Page>& page, int rotation)
     : m_page{page}
+    , m_rotation{rotation}
 {
 }
 
 PageRenderer::RenderDimensions PageRenderer::getRenderDimensions(int targetSize) const
 {
-    const Page::Size outputSize = m_page->scaledRotatedSize(targetSize);
-    const Page::Size rotatedSize = m_page->rotatedSize();
+    const Page::Size outputSize = m_page->scaledRotatedSize(targetSize, m_rotation);
+    const Page::Size rotatedSize = m_page->rotatedSize(m_rotation);
     double scale;
 
     if (rotatedSize.width >= rotatedSize.height)
@@ -37,7 +112,7 @@ PageRenderer::RenderDimensions PageRenderer::getRenderDimensions(int targetSize)
         scale = static_cast<double>(outputSize.height) / rotatedSize.height;
 
     // The rotation used for rendering depends on the source page orientation
-    int renderRotationDegrees = m_page->currentRotation() - m_page->sourceRotation();
+    int renderRotationDegrees = m_rotation - m_page->sourceRotation();
 
     if (renderRotationDegrees < 0)
         renderRotationDegrees += 360;
@@ -58,36 +133,93 @@ PageRenderer::RenderDimensions PageRenderer::getRenderDimensions(int targetSize)
 }
 
 Glib::RefPtr<Gdk::Pixbuf> PageRenderer::render(int targetSize) const
+{
+    const Page::Size outputSize = m_page->scaledRotatedSize(targetSize, m_rotation);
+
+    return renderArea(targetSize, {0, 0, outputSize.width, outputSize.height});
+}
+
+Glib::RefPtr<Gdk::Pixbuf> PageRenderer::renderArea(int targetSize, const Gdk::Rectangle& area) const
+{
+    const Page::Size outputSize = m_page->scaledRotatedSize(targetSize, m_rotation);
+    Glib::RefPtr<Gdk::Pixbuf> pixbuf = renderArea(targetSize, area, poppler::page_renderer::text_antialiasing);
+
+    const PixelOperations::OutlineEdges edges{area.get_y() == 0,
+                                              area.get_y() + pixbuf->get_height() >= outputSize.height,
+                                              area.get_x() == 0,
+                                              area.get_x() + pixbuf->get_width() >= outputSize.width};
+    drawOutline(pixbuf, edges);
+
+    return pixbuf;
+}
+
+Glib::RefPtr<Gdk::Pixbuf> PageRenderer::renderDraft(int targetSize) const
+{
+    const Page::Size outputSize = m_page->scaledRotatedSize(targetSize, m_rotation);
+    const int draftSize = std::max(1, targetSize / draftDivisor);
+    const Page::Size draftOutputSize = m_page->scaledRotatedSize(draftSize, m_rotation);
+
+    Glib::RefPtr<Gdk::Pixbuf> draft = renderArea(draftSize, {0, 0, draftOutputSize.width, draftOutputSize.height}, 0);
+
+    // The outline goes on the scaled up draft, so that it is as sharp as in the final render
+    Glib::RefPtr<Gdk::Pixbuf> scaledDraft = draft->scale_simple(outputSize.width, outputSize.height, Gdk::INTERP_BILINEAR);
+    drawOutline(scaledDraft, {});
+
+    return scaledDraft;
+}
+
+void PageRenderer::drawOutline(const Glib::RefPtr<Gdk::Pixbuf>& pixbuf, PixelOperations::OutlineEdges edges)
+{
+    PixelOperations::drawOutline(pixbuf->get_pixels(),
+                                 pixbuf->get_width(),
+                                 pixbuf->get_height(),
+                                 pixbuf->get_rowstride(),
+                                 edges);
+}
+
+Glib::RefPtr<Gdk::Pixbuf> PageRenderer::renderArea(int targetSize,
+                                                   const Gdk::Rectangle& area,
+                                                   int renderHints) const
 {
     poppler::page_renderer renderer;
-    renderer.set_render_hint(poppler::page_renderer::text_antialiasing);
+    renderer.set_render_hints(renderHints);
 
     const auto [outputSize, scale, renderRotation] = getRenderDimensions(targetSize);
 
-    poppler::image image = renderer.render_page(m_page->m_ppage.get(),
-                                                standardDpi * scale,
-                                                standardDpi * scale,
-                                                -1,
-                                                -1,
-                                                outputSize.width,
-                                                outputSize.height,
-                                                renderRotation);
-
-    const int stride = Cairo::ImageSurface::format_stride_for_width(Cairo::FORMAT_ARGB32, outputSize.width);
-    auto surface = Cairo::ImageSurface::create(reinterpret_cast<unsigned char*>(image.data()), //NOLINT
-                                               Cairo::FORMAT_ARGB32,
-                                               outputSize.width,
-                                               outputSize.height,
-                                               stride);
-
-    // Paint a black outline
-    auto cr = Cairo::Context::create(surface);
-    cr->set_line_width(1);
-    cr->set_source_rgb(0, 0, 0);
-    cr->rectangle(0, 0, outputSize.width, outputSize.height);
-    cr->stroke();
-
-    return Gdk::Pixbuf::create(surface, 0, 0, outputSize.width, outputSize.height);
+    const std::shared_ptr<poppler::document> document = threadLocalDocument(m_page->filePath());
+    std::unique_ptr<poppler::page> ppage{document->create_page(static_cast<int>(m_page->indexInFile()))};
+
+    if (ppage == nullptr)
+        throw std::runtime_error("Couldn't load page with number: " + std::to_string(m_page->indexInFile()));
+
+    // Kept on the heap, so that the pixbuf can use its pixels without a copy
+    auto image = std::make_unique<poppler::image>(renderer.render_page(ppage.get(),
+                                                                       standardDpi * scale,
+                                                                       standardDpi * scale,
+                                                                       area.get_x(),
+                                                                       area.get_y(),
+                                                                       area.get_width(),
+                                                                       area.get_height(),
+                                                                       renderRotation));
+
+    if (!image->is_valid())
+        throw std::runtime_error("Couldn't render page with number: " + std::to_string(m_page->indexInFile()));
+
+    auto* data = reinterpret_cast<std::uint8_t*>(image->data()); //NOLINT
+    const int width = image->width();
+    const int height = image->height();
+    const int stride = image->bytes_per_row();
+
+    PixelOperations::argb32ToRgba(data, width, height, stride);
+
+    return Gdk::Pixbuf::create_from_data(data,
+                                         Gdk::COLORSPACE_RGB,
+                                         true,
+                                         8,
+                                         width,
+                                         height,
+                                         stride,
+                                         [ownedImage = image.release()](const guint8*) { delete ownedImage; }); //NOLINT
 }
 
 } // namespace Slicer
@@ -18,15 +18,32 @@
 #define PAGERENDERER_HPP
 
 #include "page.hpp"
+#include "pixeloperations.hpp"
+#include <gdkmm/rectangle.h>
 
 namespace Slicer {
 
 class PageRenderer {
 public:
-    PageRenderer(const Glib::RefPtr<const Page>& page);
+    // Renders the page with the given rotation, instead of the one it has when rendering,
+    // as the page can be rotated on the main thread while a rendering thread renders it
+    PageRenderer(const Glib::RefPtr<const Page>& page, int rotation);
 
     [[nodiscard]] Glib::RefPtr<Gdk::Pixbuf> render(int targetSize) const;
 
+    // Renders only the given area of the page, as laid out at targetSize
+    [[nodiscard]] Glib::RefPtr<Gdk::Pixbuf> renderArea(int targetSize, const Gdk::Rectangle& area) const;
+
+    // A quick, low resolution render without antialiasing, scaled up to targetSize.
+    // Meant to be shown while the real render is in progress.
+    [[nodiscard]] Glib::RefPtr<Gdk::Pixbuf> renderDraft(int targetSize) const;
+
+    // Rendering threads keep their poppler documents, with all the pages and fonts
+    // poppler caches, open between renders. These close them right away, except the
+    // ones being rendered, which close when their render ends.
+    static void releaseDocuments();
+    static void releaseDocuments(const std::string& filePath);
+
 private:
     struct RenderDimensions {
         Page::Size outputSize;
@@ -35,9 +52,16 @@ private:
     };
 
     const Glib::RefPtr<const Page>& m_page;
+    const int m_rotation;
 
     static constexpr double standardDpi = 72.0;
+    static constexpr int draftDivisor = 4;
     [[nodiscard]] RenderDimensions getRenderDimensions(int targetSize) const;
+    // Without the outline, which goes on the final image
+    [[nodiscard]] Glib::RefPtr<Gdk::Pixbuf> renderArea(int targetSize,
+                                                       const Gdk::Rectangle& area,
+                                                       int renderHints) const;
+    static void drawOutline(const Glib::RefPtr<Gdk::Pixbuf>& pixbuf, PixelOperations::OutlineEdges edges);
 };
 
 } // namespace Slicer
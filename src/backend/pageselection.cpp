@@ -0,0 +1,378 @@
+// PDF Slicer
+// Copyright (C) 2019 Julián Unrrein
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "pageselection.hpp"
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+
+namespace Slicer {
+
+void PageSelection::reset(unsigned int numberOfPages)
+{
+    m_ranges.clear();
+    m_size = numberOfPages;
+    m_count = 0;
+}
+
+void PageSelection::select(unsigned int first, unsigned int last)
+{
+    if (first > last || last >= m_size)
+        throw std::out_of_range("Selection range out of bounds");
+
+    assign(first, last + 1, true);
+}
+
+void PageSelection::select(const std::vector<unsigned int>& indexes)
+{
+    auto runFirst = indexes.begin();
+
+    while (runFirst != indexes.end()) {
+        auto runLast = runFirst;
+
+        while (std::next(runLast) != indexes.end() && *std::next(runLast) == *runLast + 1)
+            ++runLast;
+
+        select(*runFirst, *runLast);
+        runFirst = std::next(runLast);
+    }
+}
+
+void PageSelection::deselect(unsigned int first, unsigned int last)
+{
+    if (first > last || last >= m_size)
+        throw std::out_of_range("Selection range out of bounds");
+
+    assign(first, last + 1, false);
+}
+
+void PageSelection::set(unsigned int index, bool selected)
+{
+    if (index >= m_size)
+        throw std::out_of_range("Selection index out of bounds");
+
+    assign(index, index + 1, selected);
+}
+
+void PageSelection::selectAll()
+{
+    m_ranges.clear();
+    m_count = 0;
+    addRange(0, m_size);
+}
+
+void PageSelection::clear()
+{
+    m_ranges.clear();
+    m_count = 0;
+}
+
+void PageSelection::invert()
+{
+    std::map<unsigned int, unsigned int> selectedRanges;
+    selectedRanges.swap(m_ranges);
+    m_count = 0;
+
+    unsigned int gapFirst = 0;
+
+    for (const auto& [first, end] : selectedRanges) {
+        addRange(gapFirst, first);
+        gapFirst = end;
+    }
+
+    addRange(gapFirst, m_size);
+}
+
+void PageSelection::selectEveryOther(unsigned int first)
+{
+    clear();
+
+    for (unsigned int i = first; i < m_size; i += 2)
+        m_ranges.emplace_hint(m_ranges.end(), i, i + 1);
+
+    m_count = first < m_size ? (m_size - first + 1) / 2 : 0;
+}
+
+void PageSelection::insert(unsigned int position, unsigned int count)
+{
+    if (position > m_size)
+        throw std::out_of_range("Insertion position out of bounds");
+
+    if (count == 0)
+        return;
+
+    std::map<unsigned int, unsigned int> ranges;
+
+    for (const auto& [first, end] : m_ranges) {
+        if (end <= position) {
+            ranges.emplace_hint(ranges.end(), first, end);
+        }
+        else if (first >= position) {
+            ranges.emplace_hint(ranges.end(), first + count, end + count);
+        }
+        else {
+            // The new pages split this range in two
+            ranges.emplace_hint(ranges.end(), first, position);
+            ranges.emplace_hint(ranges.end(), position + count, end + count);
+        }
+    }
+
+    m_ranges.swap(ranges);
+    m_size += count;
+}
+
+void PageSelection::remove(unsigned int position, unsigned int count)
+{
+    if (position + count > m_size)
+        throw std::out_of_range("Removal range out of bounds");
+
+    if (count == 0)
+        return;
+
+    assign(position, position + count, false);
+
+    std::map<unsigned int, unsigned int> ranges;
+
+    for (const auto& [first, end] : m_ranges) {
+        const unsigned int newFirst = first >= position ? first - count : first;
+        const unsigned int newEnd = first >= position ? end - count : end;
+
+        // Ranges at both sides of the removed pages become adjacent
+        if (!ranges.empty() && std::prev(ranges.end())->second == newFirst)
+            std::prev(ranges.end())->second = newEnd;
+        else
+            ranges.emplace_hint(ranges.end(), newFirst, newEnd);
+    }
+
+    m_ranges.swap(ranges);
+    m_size -= count;
+}
+
+void PageSelection::insert(const std::vector<unsigned int>& positions)
+{
+    if (positions.empty())
+        return;
+
+    const auto isNotAscending = [](unsigned int a, unsigned int b) { return a >= b; };
+
+    if (std::adjacent_find(positions.begin(), positions.end(), isNotAscending) != positions.end()
+        || positions.back() >= m_size + positions.size())
+        throw std::out_of_range("Insertion positions out of bounds");
+
+    std::map<unsigned int, unsigned int> oldRanges;
+    oldRanges.swap(m_ranges);
+    m_count = 0;
+
+    auto inserted = positions.begin();
+    unsigned int shift = 0; // Pages inserted before the current one
+
+    for (const auto& [first, end] : oldRanges) {
+        unsigned int pieceFirst = first;
+
+        // Each new page that lands inside the range splits it
+        while (pieceFirst < end) {
+            for (; inserted != positions.end() && *inserted <= pieceFirst + shift; ++inserted)
+                ++shift;
+
+            const unsigned int pieceEnd = inserted != positions.end() ? std::min(end, *inserted - shift) : end;
+            appendRange(pieceFirst + shift, pieceEnd + shift);
+            pieceFirst = pieceEnd;
+        }
+    }
+
+    m_size += static_cast<unsigned int>(positions.size());
+}
+
+void PageSelection::remove(const std::vector<unsigned int>& indexes)
+{
+    if (indexes.empty())
+        return;
+
+    const auto isNotAscending = [](unsigned int a, unsigned int b) { return a >= b; };
+
+    if (std::adjacent_find(indexes.begin(), indexes.end(), isNotAscending) != indexes.end()
+        || indexes.back() >= m_size)
+        throw std::out_of_range("Removal indexes out of bounds");
+
+    std::map<unsigned int, unsigned int> oldRanges;
+    oldRanges.swap(m_ranges);
+    m_count = 0;
+
+    auto removed = indexes.begin();
+    unsigned int shift = 0; // Pages removed before the current one
+
+    for (const auto& [first, end] : oldRanges) {
+        for (; removed != indexes.end() && *removed < first; ++removed)
+            ++shift;
+
+        // Each removed page splits the range, but what is left at both sides becomes adjacent
+        unsigned int pieceFirst = first;
+
+        for (; removed != indexes.end() && *removed < end; ++removed) {
+            appendRange(pieceFirst - shift, *removed - shift);
+            ++shift;
+            pieceFirst = *removed + 1;
+        }
+
+        appendRange(pieceFirst - shift, end - shift);
+    }
+
+    m_size -= static_cast<unsigned int>(indexes.size());
+}
+
+void PageSelection::permute(const std::vector<unsigned int>& order)
+{
+    if (order.size() != m_size)
+        throw std::out_of_range("The order doesn't cover the whole selection");
+
+    std::vector<bool> isSelectedAfter(m_size);
+
+    for (unsigned int i = 0; i < m_size; ++i)
+        isSelectedAfter.at(i) = isSelected(order.at(i));
+
+    clear();
+
+    unsigned int runFirst = 0;
+
+    for (unsigned int i = 0; i <= m_size; ++i) {
+        if (i < m_size && isSelectedAfter.at(i))
+            continue;
+
+        addRange(runFirst, i);
+        runFirst = i + 1;
+    }
+}
+
+bool PageSelection::isSelected(unsigned int index) const
+{
+    auto it = m_ranges.upper_bound(index);
+
+    if (it == m_ranges.begin())
+        return false;
+
+    return index < std::prev(it)->second;
+}
+
+unsigned int PageSelection::first() const
+{
+    if (m_ranges.empty())
+        throw std::logic_error("No page is selected");
+
+    return m_ranges.begin()->first;
+}
+
+unsigned int PageSelection::last() const
+{
+    if (m_ranges.empty())
+        throw std::logic_error("No page is selected");
+
+    return m_ranges.rbegin()->second - 1;
+}
+
+std::vector<unsigned int> PageSelection::selectedIndexes() const
+{
+    std::vector<unsigned int> indexes;
+    indexes.reserve(m_count);
+
+    for (const auto& [first, end] : m_ranges) {
+        for (unsigned int i = first; i < end; ++i)
+            indexes.push_back(i);
+    }
+
+    return indexes;
+}
+
+std::vector<unsigned int> PageSelection::unselectedIndexes() const
+{
+    std::vector<unsigned int> indexes;
+    indexes.reserve(m_size - m_count);
+    unsigned int gapFirst = 0;
+
+    for (const auto& [first, end] : m_ranges) {
+        for (unsigned int i = gapFirst; i < first; ++i)
+            indexes.push_back(i);
+
+        gapFirst = end;
+    }
+
+    for (unsigned int i = gapFirst; i < m_size; ++i)
+        indexes.push_back(i);
+
+    return indexes;
+}
+
+void PageSelection::assign(unsigned int first, unsigned int end, bool selected)
+{
+    // Start at the range before, which may overlap or touch this one
+    auto it = m_ranges.upper_bound(first);
+
+    if (it != m_ranges.begin())
+        --it;
+
+    unsigned int mergedFirst = first;
+    unsigned int mergedEnd = end;
+
+    while (it != m_ranges.end() && it->first <= end) {
+        const unsigned int rangeFirst = it->first;
+        const unsigned int rangeEnd = it->second;
+
+        if (rangeEnd < first || (!selected && (rangeEnd == first || rangeFirst == end))) {
+            ++it;
+            continue;
+        }
+
+        // Touching ranges are merged when selecting, and overlapping ones
+        // are trimmed when deselecting
+        m_count -= rangeEnd - rangeFirst;
+        it = m_ranges.erase(it);
+
+        if (selected) {
+            mergedFirst = std::min(mergedFirst, rangeFirst);
+            mergedEnd = std::max(mergedEnd, rangeEnd);
+        }
+        else {
+            addRange(rangeFirst, first);
+            addRange(end, rangeEnd);
+        }
+    }
+
+    if (selected)
+        addRange(mergedFirst, mergedEnd);
+}
+
+void PageSelection::appendRange(unsigned int first, unsigned int end)
+{
+    if (first >= end)
+        return;
+
+    if (!m_ranges.empty() && std::prev(m_ranges.end())->second == first)
+        std::prev(m_ranges.end())->second = end;
+    else
+        m_ranges.emplace_hint(m_ranges.end(), first, end);
+
+    m_count += end - first;
+}
+
+void PageSelection::addRange(unsigned int first, unsigned int end)
+{
+    if (first >= end)
+        return;
+
+    m_ranges.emplace(first, end);
+    m_count += end - first;
+}
+
+} // namespace Slicer
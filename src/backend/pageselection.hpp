@@ -0,0 +1,83 @@
+// PDF Slicer
+// Copyright (C) 2019 Julián Unrrein
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef PAGESELECTION_HPP
+#define PAGESELECTION_HPP
+
+#include <map>
+#include <vector>
+
+namespace Slicer {
+
+// Selected positions of a document, stored as disjoint ranges.
+// Bulk operations cost as much as the number of ranges, not of pages,
+// and the number of selected pages is always known.
+class PageSelection {
+public:
+    PageSelection() = default;
+
+    // All pages start unselected
+    void reset(unsigned int numberOfPages);
+
+    void select(unsigned int first, unsigned int last);
+    // Each run of consecutive indexes is selected at once
+    void select(const std::vector<unsigned int>& indexes);
+    void deselect(unsigned int first, unsigned int last);
+    void set(unsigned int index, bool selected);
+    void selectAll();
+    void clear();
+    void invert();
+    // Selects one in every two pages, starting at first, and deselects the rest
+    void selectEveryOther(unsigned int first);
+
+    // Keep the selection of the pages in place when pages are added or removed.
+    // Inserted pages are unselected.
+    void insert(unsigned int position, unsigned int count);
+    void remove(unsigned int position, unsigned int count);
+    // Inserts unselected pages at scattered positions, the ones they take after the
+    // insertion, given in ascending order, in a single pass
+    void insert(const std::vector<unsigned int>& positions);
+    // Removes scattered pages, given in ascending order, in a single pass
+    void remove(const std::vector<unsigned int>& indexes);
+    // Follows the pages when the one at order[i] goes to position i
+    void permute(const std::vector<unsigned int>& order);
+
+    bool isSelected(unsigned int index) const;
+    unsigned int size() const { return m_size; }
+    unsigned int count() const { return m_count; }
+    bool isContiguous() const { return m_ranges.size() == 1; }
+    // Only valid when some page is selected
+    unsigned int first() const;
+    unsigned int last() const;
+
+    std::vector<unsigned int> selectedIndexes() const;
+    std::vector<unsigned int> unselectedIndexes() const;
+
+private:
+    // First position to one past the last, for each range
+    std::map<unsigned int, unsigned int> m_ranges;
+    unsigned int m_size = 0;
+    unsigned int m_count = 0;
+
+    void assign(unsigned int first, unsigned int end, bool selected);
+    void addRange(unsigned int first, unsigned int end);
+    // Adds a range after all the others, merging it with the last one if they touch
+    void appendRange(unsigned int first, unsigned int end);
+};
+
+} // namespace Slicer
+
+#endif // PAGESELECTION_HPP
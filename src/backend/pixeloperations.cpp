@@ -0,0 +1,314 @@
+// PDF Slicer
+// Copyright (C) 2019 Julián Unrrein
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "pixeloperations.hpp"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace Slicer::PixelOperations {
+
+static void argb32PixelToRgba(std::uint8_t* pixel)
+{
+    std::uint32_t argb;
+    std::memcpy(&argb, pixel, sizeof(argb));
+
+    const std::uint32_t alpha = argb >> 24U;
+    std::uint32_t red = (argb >> 16U) & 0xffU;
+    std::uint32_t green = (argb >> 8U) & 0xffU;
+    std::uint32_t blue = argb & 0xffU;
+
+    if (alpha != 0xff && alpha != 0) {
+        red = (red * 255 + alpha / 2) / alpha;
+        green = (green * 255 + alpha / 2) / alpha;
+        blue = (blue * 255 + alpha / 2) / alpha;
+    }
+
+    pixel[0] = static_cast<std::uint8_t>(red);
+    pixel[1] = static_cast<std::uint8_t>(green);
+    pixel[2] = static_cast<std::uint8_t>(blue);
+    pixel[3] = static_cast<std::uint8_t>(alpha);
+}
+
+#if defined(__SSE2__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+// Opaque pixels need no unpremultiplying, so four of them at a time only need
+// their red and blue bytes swapped. Rendered pages are almost always opaque.
+static int argb32RowToRgbaSse2(std::uint8_t* row, int width)
+{
+    const __m128i alphaMask = _mm_set1_epi32(static_cast<int>(0xff000000U));
+    const __m128i greenAlphaMask = _mm_set1_epi32(static_cast<int>(0xff00ff00U));
+    const __m128i lowByteMask = _mm_set1_epi32(0xff);
+    int x = 0;
+
+    for (; x + 4 <= width; x += 4) {
+        auto* pixels = reinterpret_cast<__m128i*>(row + x * 4); //NOLINT
+        const __m128i argb = _mm_loadu_si128(pixels);
+
+        if (_mm_movemask_epi8(_mm_cmpeq_epi32(_mm_and_si128(argb, alphaMask), alphaMask)) != 0xffff) {
+            for (int i = 0; i < 4; ++i)
+                argb32PixelToRgba(row + (x + i) * 4);
+
+            continue;
+        }
+
+        const __m128i greenAlpha = _mm_and_si128(argb, greenAlphaMask);
+        const __m128i red = _mm_and_si128(_mm_srli_epi32(argb, 16), lowByteMask);
+        const __m128i blue = _mm_slli_epi32(_mm_and_si128(argb, lowByteMask), 16);
+        _mm_storeu_si128(pixels, _mm_or_si128(greenAlpha, _mm_or_si128(red, blue)));
+    }
+
+    return x;
+}
+#endif
+
+void argb32ToRgba(std::uint8_t* data, int width, int height, int stride)
+{
+    for (int y = 0; y < height; ++y) {
+        std::uint8_t* row = data + static_cast<std::ptrdiff_t>(y) * stride;
+        int x = 0;
+
+#if defined(__SSE2__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+        x = argb32RowToRgbaSse2(row, width);
+#endif
+
+        for (; x < width; ++x)
+            argb32PixelToRgba(row + x * 4);
+    }
+}
+
+static void darkenPixel(std::uint8_t* pixel)
+{
+    // Half coverage of black over the pixel
+    for (int channel = 0; channel < 3; ++channel)
+        pixel[channel] = static_cast<std::uint8_t>((pixel[channel] + 1) / 2);
+
+    pixel[3] = static_cast<std::uint8_t>(pixel[3] + (255 - pixel[3] + 1) / 2);
+}
+
+void drawOutline(std::uint8_t* data, int width, int height, int stride, OutlineEdges edges)
+{
+    if (width <= 0 || height <= 0)
+        return;
+
+    auto row = [data, stride](int y) { return data + static_cast<std::ptrdiff_t>(y) * stride; };
+
+    for (int x = 0; x < width; ++x) {
+        if (edges.top)
+            darkenPixel(row(0) + x * 4);
+
+        if (edges.bottom)
+            darkenPixel(row(height - 1) + x * 4);
+    }
+
+    for (int y = 0; y < height; ++y) {
+        if (edges.left)
+            darkenPixel(row(y));
+
+        if (edges.right)
+            darkenPixel(row(y) + (width - 1) * 4);
+    }
+}
+
+// Pixels are moved as 32-bit words, whatever their channel order
+using Pixel = std::uint32_t;
+
+// Blocks small enough that a block's source and destination rows stay in cache
+static constexpr int rotationBlockSize = 32;
+
+struct RotationBuffers {
+    const std::uint8_t* source;
+    int width;
+    int height;
+    int sourceStride;
+    std::uint8_t* destination;
+    int destinationStride;
+
+    Pixel read(int x, int y) const
+    {
+        Pixel pixel;
+        std::memcpy(&pixel, source + static_cast<std::ptrdiff_t>(y) * sourceStride + x * 4, sizeof(pixel));
+        return pixel;
+    }
+
+    void write(int x, int y, Pixel pixel) const
+    {
+        std::memcpy(destination + static_cast<std::ptrdiff_t>(y) * destinationStride + x * 4, &pixel, sizeof(pixel));
+    }
+};
+
+// Where the source pixel (x, y) ends up after rotating clockwise
+static void rotatedPosition(const RotationBuffers& buffers, int degrees, int x, int y, int& rotatedX, int& rotatedY)
+{
+    switch (degrees) {
+    case 90:
+        rotatedX = buffers.height - 1 - y;
+        rotatedY = x;
+        break;
+    case 180:
+        rotatedX = buffers.width - 1 - x;
+        rotatedY = buffers.height - 1 - y;
+        break;
+    default:
+        rotatedX = y;
+        rotatedY = buffers.width - 1 - x;
+    }
+}
+
+static void rotateBlockScalar(const RotationBuffers& buffers, int degrees, int left, int top, int right, int bottom)
+{
+    for (int y = top; y < bottom; ++y) {
+        for (int x = left; x < right; ++x) {
+            int rotatedX = 0;
+            int rotatedY = 0;
+            rotatedPosition(buffers, degrees, x, y, rotatedX, rotatedY);
+            buffers.write(rotatedX, rotatedY, buffers.read(x, y));
+        }
+    }
+}
+
+#ifdef __SSE2__
+// Rotates the 4x4 block of pixels whose top left corner is (x, y)
+static void rotateBlockSse2(const RotationBuffers& buffers, int degrees, int x, int y)
+{
+    auto load = [&](int row) {
+        return _mm_loadu_si128(reinterpret_cast<const __m128i*>(buffers.source + static_cast<std::ptrdiff_t>(y + row) * buffers.sourceStride + x * 4)); //NOLINT
+    };
+
+    auto store = [&](int destinationX, int destinationY, __m128i pixels) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(buffers.destination + static_cast<std::ptrdiff_t>(destinationY) * buffers.destinationStride + destinationX * 4), pixels); //NOLINT
+    };
+
+    const __m128i row0 = load(0);
+    const __m128i row1 = load(1);
+    const __m128i row2 = load(2);
+    const __m128i row3 = load(3);
+
+    if (degrees == 180) {
+        const int destinationX = buffers.width - 4 - x;
+        store(destinationX, buffers.height - 1 - y, _mm_shuffle_epi32(row0, _MM_SHUFFLE(0, 1, 2, 3)));
+        store(destinationX, buffers.height - 2 - y, _mm_shuffle_epi32(row1, _MM_SHUFFLE(0, 1, 2, 3)));
+        store(destinationX, buffers.height - 3 - y, _mm_shuffle_epi32(row2, _MM_SHUFFLE(0, 1, 2, 3)));
+        store(destinationX, buffers.height - 4 - y, _mm_shuffle_epi32(row3, _MM_SHUFFLE(0, 1, 2, 3)));
+        return;
+    }
+
+    // Transpose, so that each register holds a column of the block
+    const __m128i low01 = _mm_unpacklo_epi32(row0, row1);
+    const __m128i high01 = _mm_unpackhi_epi32(row0, row1);
+    const __m128i low23 = _mm_unpacklo_epi32(row2, row3);
+    const __m128i high23 = _mm_unpackhi_epi32(row2, row3);
+    __m128i columns[4] = {_mm_unpacklo_epi64(low01, low23),
+                          _mm_unpackhi_epi64(low01, low23),
+                          _mm_unpacklo_epi64(high01, high23),
+                          _mm_unpackhi_epi64(high01, high23)};
+
+    for (int column = 0; column < 4; ++column) {
+        if (degrees == 90)
+            store(buffers.height - 4 - y, x + column, _mm_shuffle_epi32(columns[column], _MM_SHUFFLE(0, 1, 2, 3)));
+        else
+            store(y, buffers.width - 1 - x - column, columns[column]);
+    }
+}
+#endif
+
+static void rotateBlock(const RotationBuffers& buffers, int degrees, int left, int top, int right, int bottom)
+{
+#ifdef __SSE2__
+    const int vectorRight = left + (right - left) / 4 * 4;
+    const int vectorBottom = top + (bottom - top) / 4 * 4;
+
+    for (int y = top; y < vectorBottom; y += 4)
+        for (int x = left; x < vectorRight; x += 4)
+            rotateBlockSse2(buffers, degrees, x, y);
+
+    rotateBlockScalar(buffers, degrees, vectorRight, top, right, vectorBottom);
+    rotateBlockScalar(buffers, degrees, left, vectorBottom, right, bottom);
+#else
+    rotateBlockScalar(buffers, degrees, left, top, right, bottom);
+#endif
+}
+
+static int normalizedDegrees(int degrees)
+{
+    return ((degrees % 360) + 360) % 360;
+}
+
+void rotate(const std::uint8_t* source,
+            int width,
+            int height,
+            int sourceStride,
+            std::uint8_t* destination,
+            int destinationStride,
+            int degrees)
+{
+    degrees = normalizedDegrees(degrees);
+
+    if (degrees % 90 != 0)
+        throw std::invalid_argument("Rotations must be multiples of 90 degrees");
+
+    if (degrees == 0) {
+        for (int y = 0; y < height; ++y)
+            std::memcpy(destination + static_cast<std::ptrdiff_t>(y) * destinationStride,
+                        source + static_cast<std::ptrdiff_t>(y) * sourceStride,
+                        static_cast<std::size_t>(width) * 4);
+        return;
+    }
+
+    const RotationBuffers buffers{source, width, height, sourceStride, destination, destinationStride};
+
+    for (int top = 0; top < height; top += rotationBlockSize)
+        for (int left = 0; left < width; left += rotationBlockSize)
+            rotateBlock(buffers,
+                        degrees,
+                        left,
+                        top,
+                        std::min(left + rotationBlockSize, width),
+                        std::min(top + rotationBlockSize, height));
+}
+
+Glib::RefPtr<Gdk::Pixbuf> rotate(const Glib::RefPtr<Gdk::Pixbuf>& pixbuf, int degrees)
+{
+    degrees = normalizedDegrees(degrees);
+
+    if (degrees == 0)
+        return pixbuf;
+
+    if (pixbuf->get_n_channels() != 4 || pixbuf->get_bits_per_sample() != 8) {
+        // GdkPixbuf counts rotations counterclockwise
+        return pixbuf->rotate_simple(static_cast<Gdk::PixbufRotation>(360 - degrees));
+    }
+
+    const bool isQuarterTurn = degrees != 180;
+    const int rotatedWidth = isQuarterTurn ? pixbuf->get_height() : pixbuf->get_width();
+    const int rotatedHeight = isQuarterTurn ? pixbuf->get_width() : pixbuf->get_height();
+    auto rotated = Gdk::Pixbuf::create(Gdk::COLORSPACE_RGB, true, 8, rotatedWidth, rotatedHeight);
+
+    rotate(pixbuf->get_pixels(),
+           pixbuf->get_width(),
+           pixbuf->get_height(),
+           pixbuf->get_rowstride(),
+           rotated->get_pixels(),
+           rotated->get_rowstride(),
+           degrees);
+
+    return rotated;
+}
+
+} // namespace Slicer::PixelOperations
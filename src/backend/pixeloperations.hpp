@@ -0,0 +1,55 @@
+// PDF Slicer
+// Copyright (C) 2019 Julián Unrrein
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef PIXELOPERATIONS_HPP
+#define PIXELOPERATIONS_HPP
+
+#include <cstdint>
+#include <gdkmm/pixbuf.h>
+
+namespace Slicer::PixelOperations {
+
+// Converts, in place, native-endian premultiplied ARGB32 pixels (as rendered by
+// poppler and cairo) to the non-premultiplied RGBA byte order used by Gdk::Pixbuf
+void argb32ToRgba(std::uint8_t* data, int width, int height, int stride);
+
+struct OutlineEdges {
+    bool top = true;
+    bool bottom = true;
+    bool left = true;
+    bool right = true;
+};
+
+// Paints a black one-pixel outline over RGBA pixels, with the same coverage that
+// stroking a one-pixel-wide rectangle around the image gives in cairo.
+// Tiles of a larger image only get the edges they share with it.
+void drawOutline(std::uint8_t* data, int width, int height, int stride, OutlineEdges edges = {});
+
+// Rotates four-byte pixels clockwise by a multiple of 90 degrees, into a buffer
+// with room for the rotated image (height x width for 90 and 270 degrees)
+void rotate(const std::uint8_t* source,
+            int width,
+            int height,
+            int sourceStride,
+            std::uint8_t* destination,
+            int destinationStride,
+            int degrees);
+
+// Returns a new pixbuf rotated clockwise, or the same one when degrees is a multiple of 360
+Glib::RefPtr<Gdk::Pixbuf> rotate(const Glib::RefPtr<Gdk::Pixbuf>& pixbuf, int degrees);
+}
+
+#endif // PIXELOPERATIONS_HPP
@@ -0,0 +1,169 @@
+// PDF Slicer
+// Copyright (C) 2019 Julián Unrrein
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "thumbnailcache.hpp"
+
+namespace Slicer {
+
+ThumbnailCache::Key::Key(const Page& page, int size)
+    : fileIdentity{page.fileHash()}
+    , indexInFile{page.indexInFile()}
+    , rotation{page.currentRotation()}
+    , targetSize{size}
+{
+}
+
+bool ThumbnailCache::Key::operator==(const Key& other) const
+{
+    return fileIdentity == other.fileIdentity
+           && indexInFile == other.indexInFile
+           && rotation == other.rotation
+           && targetSize == other.targetSize;
+}
+
+std::size_t ThumbnailCache::KeyHash::operator()(const Key& key) const
+{
+    std::size_t result = std::hash<std::string>{}(key.fileIdentity);
+
+    for (std::size_t value : {static_cast<std::size_t>(key.indexInFile),
+                              static_cast<std::size_t>(key.rotation),
+                              static_cast<std::size_t>(key.targetSize)})
+        result ^= value + 0x9e3779b9 + (result << 6) + (result >> 2);
+
+    return result;
+}
+
+ThumbnailCache::ThumbnailCache(std::size_t byteBudget,
+                               std::unique_ptr<DiskThumbnailCache> diskCache)
+    : m_byteBudget{byteBudget}
+    , m_diskCache{std::move(diskCache)}
+{
+}
+
+Glib::RefPtr<Gdk::Pixbuf> ThumbnailCache::get(const Key& key)
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+
+    auto it = m_index.find(key);
+
+    if (it == m_index.end())
+        return {};
+
+    m_entries.splice(m_entries.begin(), m_entries, it->second);
+
+    return it->second->second;
+}
+
+bool ThumbnailCache::contains(const Key& key) const
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+
+    return m_index.find(key) != m_index.end();
+}
+
+Glib::RefPtr<Gdk::Pixbuf> ThumbnailCache::load(const Key& key)
+{
+    if (Glib::RefPtr<Gdk::Pixbuf> thumbnail = get(key))
+        return thumbnail;
+
+    if (m_diskCache == nullptr)
+        return {};
+
+    Glib::RefPtr<Gdk::Pixbuf> thumbnail = m_diskCache->load(key.fileIdentity, diskEntryName(key));
+
+    if (thumbnail)
+        insert(key, thumbnail);
+
+    return thumbnail;
+}
+
+void ThumbnailCache::insert(const Key& key, const Glib::RefPtr<Gdk::Pixbuf>& thumbnail)
+{
+    const std::size_t thumbnailSize = sizeInBytes(thumbnail);
+
+    if (thumbnailSize > m_byteBudget)
+        return;
+
+    std::lock_guard<std::mutex> lock{m_mutex};
+
+    if (auto it = m_index.find(key); it != m_index.end()) {
+        m_usedBytes -= sizeInBytes(it->second->second);
+        m_entries.erase(it->second);
+        m_index.erase(it);
+    }
+
+    m_entries.emplace_front(key, thumbnail);
+    m_index.emplace(key, m_entries.begin());
+    m_usedBytes += thumbnailSize;
+
+    evictUntilUsing(m_byteBudget);
+}
+
+void ThumbnailCache::persist(const Key& key, const Glib::RefPtr<Gdk::Pixbuf>& thumbnail)
+{
+    insert(key, thumbnail);
+
+    if (m_diskCache != nullptr)
+        m_diskCache->store(key.fileIdentity, diskEntryName(key), thumbnail);
+}
+
+void ThumbnailCache::clear()
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+
+    m_index.clear();
+    m_entries.clear();
+    m_usedBytes = 0;
+}
+
+void ThumbnailCache::shrink(std::size_t bytes)
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+
+    evictUntilUsing(bytes);
+}
+
+std::size_t ThumbnailCache::usedBytes() const
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+
+    return m_usedBytes;
+}
+
+void ThumbnailCache::evictUntilUsing(std::size_t bytes)
+{
+    while (m_usedBytes > bytes) {
+        const Entry& leastRecentlyUsed = m_entries.back();
+
+        m_usedBytes -= sizeInBytes(leastRecentlyUsed.second);
+        m_index.erase(leastRecentlyUsed.first);
+        m_entries.pop_back();
+    }
+}
+
+std::size_t ThumbnailCache::sizeInBytes(const Glib::RefPtr<Gdk::Pixbuf>& thumbnail)
+{
+    return thumbnail->get_byte_length();
+}
+
+std::string ThumbnailCache::diskEntryName(const Key& key)
+{
+    return std::to_string(key.indexInFile)
+           + "-" + std::to_string(key.rotation)
+           + "-" + std::to_string(key.targetSize);
+}
+
+} // namespace Slicer
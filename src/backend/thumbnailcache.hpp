@@ -0,0 +1,95 @@
+// PDF Slicer
+// Copyright (C) 2019 Julián Unrrein
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef THUMBNAILCACHE_HPP
+#define THUMBNAILCACHE_HPP
+
+#include "diskthumbnailcache.hpp"
+#include "page.hpp"
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+namespace Slicer {
+
+// Least-recently-used cache of rendered pages, bounded by the memory
+// their pixels take. It's safe to use from several threads at once.
+// Optionally, it's backed by a persistent cache on disk.
+class ThumbnailCache {
+public:
+    struct Key {
+        std::string fileIdentity;
+        unsigned int indexInFile;
+        int rotation;
+        int targetSize;
+
+        Key(const Page& page, int size);
+
+        bool operator==(const Key& other) const;
+    };
+
+    explicit ThumbnailCache(std::size_t byteBudget,
+                            std::unique_ptr<DiskThumbnailCache> diskCache = nullptr);
+
+    ThumbnailCache(const ThumbnailCache&) = delete;
+    ThumbnailCache& operator=(const ThumbnailCache&) = delete;
+    ThumbnailCache(ThumbnailCache&&) = delete;
+    ThumbnailCache& operator=(ThumbnailCache&& src) = delete;
+
+    ~ThumbnailCache() = default;
+
+    // Both return an empty RefPtr if the thumbnail isn't cached.
+    // get() only looks in memory, while load() also reads the disk cache,
+    // so it should only be called from background threads.
+    Glib::RefPtr<Gdk::Pixbuf> get(const Key& key);
+    Glib::RefPtr<Gdk::Pixbuf> load(const Key& key);
+
+    // Only looks in memory, and doesn't count as a use of the thumbnail
+    bool contains(const Key& key) const;
+
+    // insert() only stores in memory, while persist() also writes to disk
+    void insert(const Key& key, const Glib::RefPtr<Gdk::Pixbuf>& thumbnail);
+    void persist(const Key& key, const Glib::RefPtr<Gdk::Pixbuf>& thumbnail);
+    void clear();
+    // Evicts the least recently used thumbnails from memory, until at most this much is used
+    void shrink(std::size_t bytes);
+
+    std::size_t usedBytes() const;
+    std::size_t byteBudget() const { return m_byteBudget; }
+
+private:
+    struct KeyHash {
+        std::size_t operator()(const Key& key) const;
+    };
+
+    using Entry = std::pair<Key, Glib::RefPtr<Gdk::Pixbuf>>;
+    using EntryList = std::list<Entry>;
+
+    const std::size_t m_byteBudget;
+    const std::unique_ptr<DiskThumbnailCache> m_diskCache;
+    std::size_t m_usedBytes = 0;
+    EntryList m_entries; // Most recently used first
+    std::unordered_map<Key, EntryList::iterator, KeyHash> m_index;
+    mutable std::mutex m_mutex;
+
+    void evictUntilUsing(std::size_t bytes);
+    static std::size_t sizeInBytes(const Glib::RefPtr<Gdk::Pixbuf>& thumbnail);
+    static std::string diskEntryName(const Key& key);
+};
+
+} // namespace Slicer
+
+#endif // THUMBNAILCACHE_HPP
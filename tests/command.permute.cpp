@@ -0,0 +1,238 @@
+#include "common.hpp"
+#include <catch.hpp>
+#include <command.hpp>
+#include <pageselection.hpp>
+#include <optional>
+
+using namespace Slicer;
+
+SCENARIO("Permuting the pages of a document in a single pass")
+{
+    GIVEN("A multipage PDF document with 15 pages")
+    {
+        auto multipagePdfFile = Gio::File::create_for_path(multipage1Path);
+        Document doc{multipagePdfFile};
+        REQUIRE(doc.numberOfPages() == 15);
+
+        unsigned int numberOfChanges = 0;
+        doc.pages()->signal_items_changed().connect([&numberOfChanges](guint, guint, guint) {
+            ++numberOfChanges;
+        });
+
+        WHEN("The 3rd and the 6th pages are swapped")
+        {
+            doc.permutePages({0, 1, 5, 3, 4, 2, 6, 7, 8, 9, 10, 11, 12, 13, 14});
+
+            THEN("The store should have notified a single change")
+            REQUIRE(numberOfChanges == 1);
+
+            THEN("The swapped pages should have traded their places")
+            {
+                REQUIRE(doc.getPage(2)->indexInFile() == 5);
+                REQUIRE(doc.getPage(5)->indexInFile() == 2);
+            }
+
+            THEN("Every page should know its new place")
+            for (unsigned int i = 0; i < doc.numberOfPages(); ++i)
+                REQUIRE(doc.getPage(i)->getDocumentIndex() == i);
+        }
+
+        WHEN("Every page is left in its place")
+        {
+            doc.permutePages({0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14});
+
+            THEN("The store should not notify any change")
+            REQUIRE(numberOfChanges == 0);
+        }
+
+        WHEN("The order is not a permutation of the pages")
+        {
+            THEN("Permuting should fail if a page is missing")
+            REQUIRE_THROWS(doc.permutePages({0, 1, 2}));
+
+            THEN("Permuting should fail if a page is repeated")
+            REQUIRE_THROWS(doc.permutePages({0, 0, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14}));
+
+            THEN("Permuting should fail if a position is out of the document")
+            REQUIRE_THROWS(doc.permutePages({15, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14}));
+
+            THEN("The document should be left untouched")
+            REQUIRE(numberOfChanges == 0);
+        }
+    }
+}
+
+SCENARIO("Reversing the pages of a document using the Command abstraction")
+{
+    GIVEN("A multipage PDF document with 15 pages")
+    {
+        auto multipagePdfFile = Gio::File::create_for_path(multipage1Path);
+        Document doc{multipagePdfFile};
+        REQUIRE(doc.numberOfPages() == 15);
+
+        // Kept by position and moved along with permutations, like the view does
+        PageSelection selection;
+        selection.reset(doc.numberOfPages());
+        std::optional<PageSelection> permutedSelection;
+        doc.pagesPermuted.connect([&](const std::vector<unsigned int>& order) {
+            permutedSelection = selection;
+            permutedSelection->permute(order);
+        });
+        doc.pages()->signal_items_changed().connect([&](guint position, guint removed, guint added) {
+            if (permutedSelection.has_value()) {
+                selection = *permutedSelection;
+                permutedSelection.reset();
+            }
+            else {
+                selection.remove(position, removed);
+                selection.insert(position, added);
+            }
+        });
+
+        selection.select(0, 1);
+
+        WHEN("The pages are reversed")
+        {
+            ReversePagesCommand command{doc};
+            command.execute();
+
+            THEN("The selection should follow the pages")
+            REQUIRE(selection.selectedIndexes() == std::vector<unsigned int>{13, 14});
+
+            THEN("The pages of the file should be back to front")
+            for (unsigned int i = 0; i < doc.numberOfPages(); ++i) {
+                REQUIRE(doc.getPage(i)->indexInFile() == 14 - i);
+                REQUIRE(doc.getPage(i)->getDocumentIndex() == i);
+            }
+
+            WHEN("The command is undone")
+            {
+                command.undo();
+
+                THEN("The selected pages should be selected in their original place")
+                REQUIRE(selection.selectedIndexes() == std::vector<unsigned int>{0, 1});
+
+                THEN("The pages should be back in their original order")
+                for (unsigned int i = 0; i < doc.numberOfPages(); ++i) {
+                    REQUIRE(doc.getPage(i)->indexInFile() == i);
+                    REQUIRE(doc.getPage(i)->getDocumentIndex() == i);
+                }
+            }
+        }
+    }
+}
+
+SCENARIO("Sorting the pages of a document by their source using the Command abstraction")
+{
+    GIVEN("A document made of a 15 pages file with a 5 pages file added to the beginning")
+    {
+        auto multipagePdfFile = Gio::File::create_for_path(multipage1Path);
+        Document doc{multipagePdfFile};
+        doc.addFile(Gio::File::create_for_path(multipage2Path), 0);
+        REQUIRE(doc.numberOfPages() == 20);
+
+        WHEN("The pages are reversed and then sorted by their source")
+        {
+            ReversePagesCommand reverseCommand{doc};
+            reverseCommand.execute();
+
+            SortPagesBySourceCommand sortCommand{doc};
+            sortCommand.execute();
+
+            THEN("The pages of the first file should come first, in their order")
+            for (unsigned int i = 0; i < 15; ++i) {
+                REQUIRE(doc.getPage(i)->fileName() == multipage1Name);
+                REQUIRE(doc.getPage(i)->indexInFile() == i);
+            }
+
+            THEN("The pages of the added file should come last, in their order")
+            for (unsigned int i = 15; i < 20; ++i) {
+                REQUIRE(doc.getPage(i)->fileName() == multipage2Name);
+                REQUIRE(doc.getPage(i)->indexInFile() == i - 15);
+            }
+
+            WHEN("The sorting is undone")
+            {
+                sortCommand.undo();
+
+                THEN("The pages should be reversed again")
+                {
+                    REQUIRE(doc.getPage(0)->fileName() == multipage1Name);
+                    REQUIRE(doc.getPage(0)->indexInFile() == 14);
+                    REQUIRE(doc.getPage(19)->fileName() == multipage2Name);
+                    REQUIRE(doc.getPage(19)->indexInFile() == 0);
+                }
+            }
+        }
+    }
+}
+
+SCENARIO("Interleaving two scans of the same document using the Command abstraction")
+{
+    GIVEN("A document with the fronts (15 pages) and the backs (15 pages) of a duplex scan")
+    {
+        auto frontsFile = Gio::File::create_for_path(multipage1Path);
+        Document doc{frontsFile};
+        doc.addFile(Gio::File::create_for_path(multipage3Path), 15);
+        REQUIRE(doc.numberOfPages() == 30);
+
+        unsigned int numberOfChanges = 0;
+        doc.pages()->signal_items_changed().connect([&numberOfChanges](guint, guint, guint) {
+            ++numberOfChanges;
+        });
+
+        WHEN("The backs are interleaved back to front with the fronts")
+        {
+            InterleavePagesCommand command{doc, 0, 1, true};
+            command.execute();
+
+            THEN("The store should have notified a single change")
+            REQUIRE(numberOfChanges == 1);
+
+            THEN("Each front should be followed by its back")
+            for (unsigned int i = 0; i < 15; ++i) {
+                REQUIRE(doc.getPage(2 * i)->fileName() == multipage1Name);
+                REQUIRE(doc.getPage(2 * i)->indexInFile() == i);
+                REQUIRE(doc.getPage(2 * i + 1)->fileName() == multipage3Name);
+                REQUIRE(doc.getPage(2 * i + 1)->indexInFile() == 14 - i);
+            }
+
+            WHEN("The command is undone")
+            {
+                command.undo();
+
+                THEN("The fronts should be followed by the backs again")
+                for (unsigned int i = 0; i < 15; ++i) {
+                    REQUIRE(doc.getPage(i)->fileName() == multipage1Name);
+                    REQUIRE(doc.getPage(i)->indexInFile() == i);
+                    REQUIRE(doc.getPage(i + 15)->fileName() == multipage3Name);
+                    REQUIRE(doc.getPage(i + 15)->indexInFile() == i);
+                }
+            }
+        }
+
+        WHEN("Some of the backs are removed, and the rest interleaved in their order")
+        {
+            doc.removePages({27, 28, 29});
+
+            InterleavePagesCommand command{doc, 0, 1, false};
+            command.execute();
+
+            THEN("The fronts without a back should go at the end")
+            {
+                REQUIRE(doc.getPage(22)->fileName() == multipage1Name);
+                REQUIRE(doc.getPage(22)->indexInFile() == 11);
+                REQUIRE(doc.getPage(23)->fileName() == multipage3Name);
+                REQUIRE(doc.getPage(23)->indexInFile() == 11);
+
+                for (unsigned int i = 24; i < 27; ++i) {
+                    REQUIRE(doc.getPage(i)->fileName() == multipage1Name);
+                    REQUIRE(doc.getPage(i)->indexInFile() == i - 12);
+                }
+            }
+        }
+
+        THEN("Interleaving a file with itself should fail")
+        REQUIRE_THROWS(InterleavePagesCommand{doc, 0, 0, false});
+    }
+}
@@ -1,6 +1,7 @@
 #include "common.hpp"
 #include <catch.hpp>
 #include <document.hpp>
+#include <array>
 
 using namespace Slicer;
 
@@ -176,3 +177,46 @@ SCENARIO("Moving 2 adjacent pages across different places of a document")
         }
     }
 }
+
+SCENARIO("Moving pages only notifies the change of the pages between the old and the new place")
+{
+    GIVEN("A multipage PDF document with 15 pages")
+    {
+        auto multipagePdfFile = Gio::File::create_for_path(multipage1Path);
+        Document doc{multipagePdfFile};
+        REQUIRE(doc.numberOfPages() == 15);
+
+        std::vector<std::array<guint, 3>> changes;
+        doc.pages()->signal_items_changed().connect([&changes](guint position, guint removed, guint added) {
+            changes.push_back({position, removed, added});
+        });
+
+        WHEN("The 3rd to 5th pages are moved to the 9th place")
+        {
+            doc.movePageRange(2, 4, 8);
+
+            THEN("A single change should span from the 3rd to the 11th page")
+            {
+                REQUIRE(changes.size() == 1);
+                REQUIRE(changes.front() == std::array<guint, 3>{2, 9, 9});
+            }
+
+            THEN("Every page should know its new position in the document")
+            {
+                for (unsigned int i = 0; i < doc.numberOfPages(); ++i)
+                    REQUIRE(doc.getPage(i)->getDocumentIndex() == i);
+            }
+        }
+
+        WHEN("The 12th page is moved to the 2nd place")
+        {
+            doc.movePage(11, 1);
+
+            THEN("A single change should span from the 2nd to the 12th page")
+            {
+                REQUIRE(changes.size() == 1);
+                REQUIRE(changes.front() == std::array<guint, 3>{1, 11, 11});
+            }
+        }
+    }
+}
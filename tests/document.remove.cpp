@@ -1,6 +1,8 @@
 #include "common.hpp"
 #include <catch.hpp>
 #include <document.hpp>
+#include <pageselection.hpp>
+#include <optional>
 
 using namespace Slicer;
 
@@ -369,3 +371,95 @@ SCENARIO("Removing 2 disjoint pages from different places of a document")
         }
     }
 }
+
+SCENARIO("Removing scattered pages notifies a single change")
+{
+    GIVEN("A multipage PDF document with 15 pages")
+    {
+        auto multipagePdfFile = Gio::File::create_for_path(multipage1Path);
+        Document doc{multipagePdfFile};
+        REQUIRE(doc.numberOfPages() == 15);
+
+        unsigned int numberOfChanges = 0;
+        doc.pages()->signal_items_changed().connect([&numberOfChanges](guint, guint, guint) {
+            ++numberOfChanges;
+        });
+
+        // Kept by position and moved along with announced changes, like the view does
+        PageSelection selection;
+        selection.reset(doc.numberOfPages());
+        std::optional<PageSelection> pendingSelection;
+        doc.pagesRemoved.connect([&](const std::vector<unsigned int>& indexes) {
+            pendingSelection = selection;
+            pendingSelection->remove(indexes);
+        });
+        doc.pagesInserted.connect([&](const std::vector<unsigned int>& positions) {
+            pendingSelection = selection;
+            pendingSelection->insert(positions);
+        });
+        doc.pages()->signal_items_changed().connect([&](guint position, guint removed, guint added) {
+            if (pendingSelection.has_value()) {
+                selection = *pendingSelection;
+                pendingSelection.reset();
+            }
+            else {
+                selection.remove(position, removed);
+                selection.insert(position, added);
+            }
+        });
+
+        const std::vector<unsigned int> removedIndexes{1, 2, 5, 7, 8, 11};
+        const std::vector<unsigned int> keptIndexes{0, 3, 4, 6, 9, 10, 12, 13, 14};
+
+        for (unsigned int index : keptIndexes)
+            selection.set(index, true);
+
+        WHEN("The unselected pages are removed")
+        {
+            auto removedPages = doc.removePages(removedIndexes);
+
+            THEN("The document should have 9 pages")
+            REQUIRE(doc.numberOfPages() == 9);
+
+            THEN("The store should have notified a single change")
+            REQUIRE(numberOfChanges == 1);
+
+            THEN("The remaining pages should keep their order")
+            for (unsigned int i = 0; i < doc.numberOfPages(); ++i) {
+                REQUIRE(doc.getPage(i)->indexInFile() == keptIndexes.at(i));
+                REQUIRE(doc.getPage(i)->getDocumentIndex() == i);
+            }
+
+            THEN("The remaining pages should still be selected")
+            REQUIRE(selection.count() == doc.numberOfPages());
+
+            THEN("The removed pages should be returned in order")
+            {
+                REQUIRE(removedPages.size() == 6);
+                REQUIRE(removedPages.front()->indexInFile() == 1);
+                REQUIRE(removedPages.back()->indexInFile() == 11);
+            }
+
+            WHEN("The removed pages are inserted back")
+            {
+                doc.insertPages(removedPages);
+
+                THEN("The store should have notified a single change for the insertion")
+                REQUIRE(numberOfChanges == 2);
+
+                THEN("Only the pages that were kept should be selected")
+                REQUIRE(selection.selectedIndexes() == keptIndexes);
+
+                THEN("The document should have all the pages in their original order")
+                {
+                    REQUIRE(doc.numberOfPages() == 15);
+
+                    for (unsigned int i = 0; i < doc.numberOfPages(); ++i) {
+                        REQUIRE(doc.getPage(i)->indexInFile() == i);
+                        REQUIRE(doc.getPage(i)->getDocumentIndex() == i);
+                    }
+                }
+            }
+        }
+    }
+}
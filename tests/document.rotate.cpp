@@ -0,0 +1,138 @@
+#include "common.hpp"
+#include <catch.hpp>
+#include <document.hpp>
+#include <pageselection.hpp>
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <numeric>
+#include <optional>
+#include <sstream>
+
+using namespace Slicer;
+
+static std::vector<unsigned int> allPositions(const Document& doc)
+{
+    std::vector<unsigned int> positions(doc.numberOfPages());
+    std::iota(positions.begin(), positions.end(), 0);
+
+    return positions;
+}
+
+SCENARIO("Rotating pages notifies their positions without copying them")
+{
+    GIVEN("A multipage PDF document with 15 pages")
+    {
+        auto multipagePdfFile = Gio::File::create_for_path(multipage1Path);
+        Document doc{multipagePdfFile};
+        REQUIRE(doc.numberOfPages() == 15);
+
+        const std::vector<unsigned int>* notifiedPositions = nullptr;
+        doc.pagesRotated.connect([&notifiedPositions](const std::vector<unsigned int>& positions) {
+            notifiedPositions = &positions;
+        });
+
+        WHEN("Every page is rotated right")
+        {
+            const std::vector<unsigned int> positions = allPositions(doc);
+            doc.rotatePagesRight(positions);
+
+            THEN("Every page should be rotated")
+            for (unsigned int i = 0; i < doc.numberOfPages(); ++i)
+                REQUIRE(doc.getPage(i)->currentRotation() == 90);
+
+            THEN("The handler should have received the very same positions")
+            REQUIRE(notifiedPositions == &positions);
+        }
+    }
+}
+
+// The selection follows the changes through the same PageSelection calls the view
+// makes, while the widgets of the view are left out. Each document is twice as big
+// as the previous one, so with linear costs the biggest one takes four times as long
+// as the smallest one, and sixteen if quadratic.
+// Run it with: pdfslicer_tests [benchmark]
+TEST_CASE("Rotating, moving and removing pages scales linearly with the document", "[.][benchmark]")
+{
+    using Clock = std::chrono::steady_clock;
+
+    // Best of several runs, to leave out hiccups of the machine
+    const auto timeOf = [](const std::function<void()>& operation) {
+        Clock::duration bestTime = Clock::duration::max();
+
+        for (int i = 0; i < 5; ++i) {
+            const auto start = Clock::now();
+            operation();
+            bestTime = std::min(bestTime, Clock::now() - start);
+        }
+
+        return bestTime;
+    };
+
+    std::vector<Clock::duration> rotationTimes;
+    std::vector<Clock::duration> moveTimes;
+    std::vector<Clock::duration> removalTimes;
+
+    for (unsigned int numberOfFiles : {135, 270, 540}) {
+        const std::vector<Glib::RefPtr<Gio::File>> files(numberOfFiles,
+                                                         Gio::File::create_for_path(multipage1Path));
+        Document doc{files};
+        const std::vector<unsigned int> positions = allPositions(doc);
+        const unsigned int numberOfPages = doc.numberOfPages();
+
+        PageSelection selection;
+        selection.reset(numberOfPages);
+        std::optional<PageSelection> pendingSelection;
+        doc.pagesReordered.connect([&selection](const std::vector<unsigned int>& reorderedPositions) {
+            selection.select(reorderedPositions);
+        });
+        doc.pagesRemoved.connect([&](const std::vector<unsigned int>& indexes) {
+            pendingSelection = selection;
+            pendingSelection->remove(indexes);
+        });
+        doc.pagesInserted.connect([&](const std::vector<unsigned int>& insertedPositions) {
+            pendingSelection = selection;
+            pendingSelection->insert(insertedPositions);
+        });
+        doc.pages()->signal_items_changed().connect([&](guint position, guint removed, guint added) {
+            if (pendingSelection.has_value()) {
+                selection = std::move(*pendingSelection);
+                pendingSelection.reset();
+            }
+            else {
+                selection.remove(position, removed);
+                selection.insert(position, added);
+            }
+        });
+
+        std::vector<unsigned int> everyOtherPosition;
+
+        for (unsigned int i = 0; i < numberOfPages; i += 2)
+            everyOtherPosition.push_back(i);
+
+        rotationTimes.push_back(timeOf([&]() { doc.rotatePagesRight(positions); }));
+        moveTimes.push_back(timeOf([&]() { doc.movePageRange(1, numberOfPages - 1, 0); }));
+        removalTimes.push_back(timeOf([&]() { doc.insertPages(doc.removePages(everyOtherPosition)); }));
+
+        REQUIRE(doc.numberOfPages() == numberOfPages);
+        REQUIRE(selection.size() == numberOfPages);
+        // Every page but the last one was moved, and the removed ones were put back unselected
+        REQUIRE(selection.count() == (numberOfPages - 1) / 2);
+    }
+
+    std::ostringstream timings;
+
+    for (unsigned int i = 0; i < rotationTimes.size(); ++i)
+        timings << "Document " << i + 1 << ": rotating took "
+                << std::chrono::duration_cast<std::chrono::microseconds>(rotationTimes.at(i)).count()
+                << " us, moving took "
+                << std::chrono::duration_cast<std::chrono::microseconds>(moveTimes.at(i)).count()
+                << " us, removing and putting back took "
+                << std::chrono::duration_cast<std::chrono::microseconds>(removalTimes.at(i)).count()
+                << " us\n";
+
+    INFO(timings.str());
+    CHECK(rotationTimes.back() < 8 * rotationTimes.front());
+    CHECK(moveTimes.back() < 8 * moveTimes.front());
+    CHECK(removalTimes.back() < 8 * removalTimes.front());
+}
@@ -0,0 +1,175 @@
+#include <catch.hpp>
+#include <pageselection.hpp>
+#include <vector>
+
+using namespace Slicer;
+
+using Indexes = std::vector<unsigned int>;
+
+SCENARIO("Selecting ranges of pages")
+{
+    GIVEN("A selection of a 10-page document")
+    {
+        PageSelection selection;
+        selection.reset(10);
+
+        THEN("No page should be selected")
+        {
+            REQUIRE(selection.count() == 0);
+            REQUIRE(selection.unselectedIndexes().size() == 10);
+        }
+
+        WHEN("Two overlapping ranges are selected")
+        {
+            selection.select(2, 4);
+            selection.select(4, 6);
+
+            THEN("They should make a single contiguous range")
+            {
+                REQUIRE(selection.count() == 5);
+                REQUIRE(selection.isContiguous());
+                REQUIRE(selection.first() == 2);
+                REQUIRE(selection.last() == 6);
+            }
+
+            AND_WHEN("A page in the middle is deselected")
+            {
+                selection.set(4, false);
+
+                THEN("The range should be split in two")
+                {
+                    REQUIRE(selection.count() == 4);
+                    REQUIRE_FALSE(selection.isContiguous());
+                    REQUIRE_FALSE(selection.isSelected(4));
+                    REQUIRE(selection.selectedIndexes() == Indexes{2, 3, 5, 6});
+                }
+            }
+        }
+
+        WHEN("Two adjacent pages are selected one at a time")
+        {
+            selection.set(7, true);
+            selection.set(8, true);
+
+            THEN("They should make a single range")
+            REQUIRE(selection.isContiguous());
+        }
+
+        WHEN("Two runs of consecutive pages are selected at once")
+        {
+            selection.select(Indexes{1, 2, 3, 6, 7});
+
+            THEN("Each run should make its own range")
+            {
+                REQUIRE(selection.count() == 5);
+                REQUIRE_FALSE(selection.isContiguous());
+                REQUIRE(selection.selectedIndexes() == Indexes{1, 2, 3, 6, 7});
+            }
+        }
+
+        WHEN("Some pages are selected and the pages are reversed")
+        {
+            selection.select(0, 2);
+            selection.set(5, true);
+            selection.permute(Indexes{9, 8, 7, 6, 5, 4, 3, 2, 1, 0});
+
+            THEN("The selection should follow the pages")
+            REQUIRE(selection.selectedIndexes() == Indexes{4, 7, 8, 9});
+        }
+
+        WHEN("Odd pages are selected and then the selection is inverted")
+        {
+            selection.selectEveryOther(0);
+            selection.invert();
+
+            THEN("Only even pages should be selected")
+            {
+                REQUIRE(selection.count() == 5);
+                REQUIRE(selection.selectedIndexes() == Indexes{1, 3, 5, 7, 9});
+                REQUIRE(selection.unselectedIndexes() == Indexes{0, 2, 4, 6, 8});
+            }
+        }
+
+        WHEN("All pages are selected")
+        {
+            selection.selectAll();
+
+            THEN("The count should be the number of pages")
+            REQUIRE(selection.count() == 10);
+
+            AND_WHEN("The selection is inverted")
+            {
+                selection.invert();
+
+                THEN("No page should be selected")
+                REQUIRE(selection.count() == 0);
+            }
+        }
+    }
+}
+
+SCENARIO("Keeping the selection when pages are added or removed")
+{
+    GIVEN("A 10-page document with the 3rd to 6th pages selected")
+    {
+        PageSelection selection;
+        selection.reset(10);
+        selection.select(2, 5);
+
+        WHEN("Two pages are inserted at the 5th place")
+        {
+            selection.insert(4, 2);
+
+            THEN("The selected pages should be around the new, unselected ones")
+            {
+                REQUIRE(selection.size() == 12);
+                REQUIRE(selection.selectedIndexes() == Indexes{2, 3, 6, 7});
+            }
+        }
+
+        WHEN("Pages are inserted at scattered positions at once")
+        {
+            selection.insert(Indexes{0, 4, 5, 10});
+
+            THEN("The selected pages should be split around the new, unselected ones")
+            {
+                REQUIRE(selection.size() == 14);
+                REQUIRE(selection.count() == 4);
+                REQUIRE(selection.selectedIndexes() == Indexes{3, 6, 7, 8});
+            }
+        }
+
+        WHEN("The 4th and 5th pages are removed")
+        {
+            selection.remove(3, 2);
+
+            THEN("The remaining selected pages should make a single range")
+            {
+                REQUIRE(selection.size() == 8);
+                REQUIRE(selection.isContiguous());
+                REQUIRE(selection.selectedIndexes() == Indexes{2, 3});
+            }
+        }
+
+        WHEN("Scattered pages, inside and around the selected ones, are removed at once")
+        {
+            selection.remove(Indexes{1, 3, 4, 8});
+
+            THEN("The pages left at both sides of the removed ones should make a single range")
+            {
+                REQUIRE(selection.size() == 6);
+                REQUIRE(selection.count() == 2);
+                REQUIRE(selection.isContiguous());
+                REQUIRE(selection.selectedIndexes() == Indexes{1, 2});
+            }
+        }
+
+        WHEN("The first two pages are removed")
+        {
+            selection.remove(0, 2);
+
+            THEN("The selected pages should move to the front")
+            REQUIRE(selection.selectedIndexes() == Indexes{0, 1, 2, 3});
+        }
+    }
+}
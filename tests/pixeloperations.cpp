@@ -0,0 +1,170 @@
+#include <catch.hpp>
+#include <cstring>
+#include <pixeloperations.hpp>
+#include <vector>
+
+using namespace Slicer;
+
+static void setArgb32(std::vector<std::uint8_t>& data, int offset, std::uint32_t argb)
+{
+    std::memcpy(&data.at(static_cast<std::size_t>(offset)), &argb, sizeof(argb));
+}
+
+SCENARIO("Converting rendered pixels to the pixbuf format")
+{
+    GIVEN("A 7x3 ARGB32 image with padded rows")
+    {
+        const int width = 7;
+        const int height = 3;
+        const int stride = 32;
+        std::vector<std::uint8_t> data(stride * height, 0xab);
+
+        for (int y = 0; y < height; ++y)
+            for (int x = 0; x < width; ++x)
+                setArgb32(data, y * stride + x * 4, 0xff102030);
+
+        WHEN("All pixels are opaque")
+        {
+            PixelOperations::argb32ToRgba(data.data(), width, height, stride);
+
+            THEN("Every pixel should be in RGBA byte order")
+            {
+                for (int y = 0; y < height; ++y) {
+                    for (int x = 0; x < width; ++x) {
+                        const std::uint8_t* pixel = &data.at(y * stride + x * 4);
+                        REQUIRE(pixel[0] == 0x10);
+                        REQUIRE(pixel[1] == 0x20);
+                        REQUIRE(pixel[2] == 0x30);
+                        REQUIRE(pixel[3] == 0xff);
+                    }
+                }
+            }
+
+            THEN("The row padding should be left untouched")
+            {
+                for (int y = 0; y < height; ++y)
+                    for (int offset = width * 4; offset < stride; ++offset)
+                        REQUIRE(data.at(y * stride + offset) == 0xab);
+            }
+        }
+
+        WHEN("A pixel is translucent")
+        {
+            setArgb32(data, stride + 4, 0x80402010);
+            PixelOperations::argb32ToRgba(data.data(), width, height, stride);
+
+            THEN("Its color should be unpremultiplied")
+            {
+                const std::uint8_t* pixel = &data.at(stride + 4);
+                REQUIRE(pixel[0] == 128);
+                REQUIRE(pixel[1] == 64);
+                REQUIRE(pixel[2] == 32);
+                REQUIRE(pixel[3] == 0x80);
+            }
+
+            THEN("Its opaque neighbours should still be converted")
+            {
+                REQUIRE(data.at(stride) == 0x10);
+                REQUIRE(data.at(stride + 8) == 0x10);
+            }
+        }
+
+        WHEN("An outline is drawn over the converted image")
+        {
+            PixelOperations::argb32ToRgba(data.data(), width, height, stride);
+            PixelOperations::drawOutline(data.data(), width, height, stride);
+
+            THEN("Border pixels should be darkened, and corners darkened twice")
+            {
+                REQUIRE(data.at(4) == 0x08);
+                REQUIRE(data.at(0) == 0x04);
+                REQUIRE(data.at((height - 1) * stride + (width - 1) * 4) == 0x04);
+            }
+
+            THEN("Inner pixels should be left as they were")
+            {
+                REQUIRE(data.at(stride + 4) == 0x10);
+            }
+        }
+
+        WHEN("Only the left and top edges of the outline are drawn, as for the top left tile of a page")
+        {
+            PixelOperations::argb32ToRgba(data.data(), width, height, stride);
+            PixelOperations::drawOutline(data.data(), width, height, stride, {true, false, true, false});
+
+            THEN("The right and bottom edges should be left as they were")
+            {
+                REQUIRE(data.at(0) == 0x04);
+                REQUIRE(data.at((width - 1) * 4) == 0x08);
+                REQUIRE(data.at((height - 1) * stride) == 0x08);
+                REQUIRE(data.at((height - 1) * stride + (width - 1) * 4) == 0x10);
+            }
+        }
+    }
+}
+
+SCENARIO("Rotating pixels by multiples of 90 degrees")
+{
+    GIVEN("A 9x6 image where each pixel holds its own coordinates")
+    {
+        const int width = 9;
+        const int height = 6;
+        const int stride = width * 4;
+        std::vector<std::uint8_t> source(stride * height);
+
+        for (int y = 0; y < height; ++y)
+            for (int x = 0; x < width; ++x)
+                setArgb32(source, y * stride + x * 4, static_cast<std::uint32_t>(y * 100 + x));
+
+        auto pixelAt = [](const std::vector<std::uint8_t>& data, int rowStride, int x, int y) {
+            std::uint32_t pixel = 0;
+            std::memcpy(&pixel, &data.at(static_cast<std::size_t>(y * rowStride + x * 4)), sizeof(pixel));
+            return pixel;
+        };
+
+        WHEN("It is rotated 90 degrees")
+        {
+            std::vector<std::uint8_t> rotated(source.size());
+            PixelOperations::rotate(source.data(), width, height, stride, rotated.data(), height * 4, 90);
+
+            THEN("The left column should become the top row, from bottom to top")
+            {
+                for (int y = 0; y < height; ++y)
+                    for (int x = 0; x < width; ++x)
+                        REQUIRE(pixelAt(rotated, height * 4, height - 1 - y, x) == pixelAt(source, stride, x, y));
+            }
+        }
+
+        WHEN("It is rotated 180 degrees")
+        {
+            std::vector<std::uint8_t> rotated(source.size());
+            PixelOperations::rotate(source.data(), width, height, stride, rotated.data(), stride, 180);
+
+            THEN("It should be upside down")
+            {
+                for (int y = 0; y < height; ++y)
+                    for (int x = 0; x < width; ++x)
+                        REQUIRE(pixelAt(rotated, stride, width - 1 - x, height - 1 - y) == pixelAt(source, stride, x, y));
+            }
+        }
+
+        WHEN("It is rotated 90 and then 270 degrees")
+        {
+            std::vector<std::uint8_t> rotated(source.size());
+            std::vector<std::uint8_t> restored(source.size());
+            PixelOperations::rotate(source.data(), width, height, stride, rotated.data(), height * 4, 90);
+            PixelOperations::rotate(rotated.data(), height, width, height * 4, restored.data(), stride, 270);
+
+            THEN("It should be back to the original")
+            REQUIRE(restored == source);
+        }
+
+        WHEN("It is rotated by something other than a multiple of 90 degrees")
+        {
+            std::vector<std::uint8_t> rotated(source.size());
+
+            THEN("The rotation should be rejected")
+            REQUIRE_THROWS(PixelOperations::rotate(source.data(), width, height, stride, rotated.data(), stride, 45));
+        }
+    }
+}
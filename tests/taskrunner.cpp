@@ -0,0 +1,130 @@
+#include <catch.hpp>
+#include <taskrunner.hpp>
+#include <glibmm/main.h>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace Slicer;
+
+// Runs the main loop, where finished tasks are dispatched, until the condition holds
+static void iterateMainContextUntil(const std::function<bool()>& condition)
+{
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{10};
+
+    while (!condition() && std::chrono::steady_clock::now() < deadline) {
+        if (!Glib::MainContext::get_default()->iteration(false))
+            std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    }
+}
+
+SCENARIO("Running tasks by priority in a single rendering thread")
+{
+    GIVEN("A task runner whose only thread is busy with a task")
+    {
+        std::mutex executedMutex;
+        std::vector<std::string> executed;
+        std::vector<std::string> finished;
+
+        // Declared after what its tasks use, so that it's destroyed first
+        TaskRunner taskRunner{1};
+
+        // Tasks queued while it is blocked are taken in the order the runner chooses
+        std::promise<void> unblock;
+        auto blockingTask = std::make_shared<Task>([unblocked = unblock.get_future().share()]() { unblocked.wait(); },
+                                                   []() {});
+        taskRunner.queue(blockingTask, TaskRunner::Priority::Preview);
+
+        const auto makeTask = [&](const std::string& name) {
+            return std::make_shared<Task>(
+                [&executedMutex, &executed, name]() {
+                    std::lock_guard<std::mutex> lock{executedMutex};
+                    executed.push_back(name);
+                },
+                [&finished, name]() { finished.push_back(name); });
+        };
+
+        // Queued last, at the lowest priority, so that everything else is done when it finishes
+        const auto queueLastTask = [&]() {
+            taskRunner.queue(makeTask("last"), TaskRunner::Priority::Background);
+            unblock.set_value();
+            iterateMainContextUntil([&finished]() { return !finished.empty() && finished.back() == "last"; });
+        };
+
+        WHEN("Tasks of every priority are queued out of order")
+        {
+            taskRunner.queue(makeTask("background"), TaskRunner::Priority::Background);
+            taskRunner.queue(makeTask("visible"), TaskRunner::Priority::Visible);
+            taskRunner.queue(makeTask("prefetch"), TaskRunner::Priority::Prefetch);
+            taskRunner.queue(makeTask("draft"), TaskRunner::Priority::Draft);
+            taskRunner.queue(makeTask("second visible"), TaskRunner::Priority::Visible);
+            queueLastTask();
+
+            THEN("They should run by priority, and in queuing order within the same priority")
+            {
+                const std::vector<std::string> expected{"draft",
+                                                        "visible",
+                                                        "second visible",
+                                                        "prefetch",
+                                                        "background",
+                                                        "last"};
+                REQUIRE(executed == expected);
+                REQUIRE(finished == expected);
+            }
+        }
+
+        WHEN("A task is queued with the same owner as a queued one")
+        {
+            int owner = 0;
+            auto supersededTask = makeTask("superseded");
+            taskRunner.queue(supersededTask, TaskRunner::Priority::Visible, &owner);
+            taskRunner.queue(makeTask("superseding"), TaskRunner::Priority::Visible, &owner);
+            queueLastTask();
+
+            THEN("The older task should be canceled and never run")
+            {
+                REQUIRE(supersededTask->isCanceled());
+                REQUIRE(executed == std::vector<std::string>{"superseding", "last"});
+                REQUIRE(finished == std::vector<std::string>{"superseding", "last"});
+            }
+        }
+
+        WHEN("A queued task is canceled")
+        {
+            auto canceledTask = makeTask("canceled");
+            taskRunner.queue(canceledTask, TaskRunner::Priority::Visible);
+            canceledTask->cancel();
+            queueLastTask();
+
+            THEN("Neither its work nor its result should run")
+            {
+                REQUIRE(executed == std::vector<std::string>{"last"});
+                REQUIRE(finished == std::vector<std::string>{"last"});
+            }
+        }
+
+        WHEN("A task is canceled after its work runs, but before its result is dispatched")
+        {
+            std::atomic_bool hasRun = false;
+            auto canceledTask = std::make_shared<Task>([&hasRun]() { hasRun = true; },
+                                                       [&finished]() { finished.emplace_back("canceled"); });
+            taskRunner.queue(canceledTask, TaskRunner::Priority::Visible);
+            unblock.set_value();
+
+            while (!hasRun)
+                std::this_thread::sleep_for(std::chrono::milliseconds{1});
+
+            canceledTask->cancel();
+            taskRunner.queue(makeTask("last"), TaskRunner::Priority::Background);
+            iterateMainContextUntil([&finished]() { return !finished.empty() && finished.back() == "last"; });
+
+            THEN("Its result should not be dispatched")
+            REQUIRE(finished == std::vector<std::string>{"last"});
+        }
+    }
+}
@@ -0,0 +1,177 @@
+#include "common.hpp"
+#include <catch.hpp>
+#include <document.hpp>
+#include <tempfile.hpp>
+#include <thumbnailcache.hpp>
+#include <glibmm/fileutils.h>
+#include <glibmm/miscutils.h>
+
+using namespace Slicer;
+
+static Glib::RefPtr<Gdk::Pixbuf> createThumbnail(int size)
+{
+    return Gdk::Pixbuf::create(Gdk::COLORSPACE_RGB, true, 8, size, size);
+}
+
+SCENARIO("Caching thumbnails within a memory budget")
+{
+    GIVEN("A document and a cache with room for exactly two 100x100 thumbnails")
+    {
+        auto multipagePdfFile = Gio::File::create_for_path(multipage1Path);
+        Document doc{multipagePdfFile};
+        const std::size_t thumbnailSize = createThumbnail(100)->get_byte_length();
+        ThumbnailCache cache{2 * thumbnailSize};
+
+        const ThumbnailCache::Key firstKey{*doc.getPage(0), 100};
+        const ThumbnailCache::Key secondKey{*doc.getPage(1), 100};
+        const ThumbnailCache::Key thirdKey{*doc.getPage(2), 100};
+
+        WHEN("Nothing has been inserted")
+        {
+            THEN("Lookups should miss")
+            REQUIRE(!cache.get(firstKey));
+        }
+
+        WHEN("Two thumbnails are inserted")
+        {
+            auto firstThumbnail = createThumbnail(100);
+            cache.insert(firstKey, firstThumbnail);
+            cache.insert(secondKey, createThumbnail(100));
+
+            THEN("Both should be found")
+            {
+                REQUIRE(cache.get(firstKey) == firstThumbnail);
+                REQUIRE(cache.get(secondKey));
+                REQUIRE(cache.usedBytes() == 2 * thumbnailSize);
+            }
+
+            THEN("A different size or rotation of the same page should miss")
+            {
+                REQUIRE(!cache.get(ThumbnailCache::Key{*doc.getPage(0), 200}));
+
+                doc.rotatePagesRight({0});
+                REQUIRE(!cache.get(ThumbnailCache::Key{*doc.getPage(0), 100}));
+            }
+
+            WHEN("The first one is used and a third one is inserted")
+            {
+                cache.get(firstKey);
+                cache.insert(thirdKey, createThumbnail(100));
+
+                THEN("The least recently used thumbnail should be evicted")
+                {
+                    REQUIRE(cache.get(firstKey));
+                    REQUIRE(!cache.get(secondKey));
+                    REQUIRE(cache.get(thirdKey));
+                    REQUIRE(cache.usedBytes() == 2 * thumbnailSize);
+                }
+            }
+
+            WHEN("The cache is cleared")
+            {
+                cache.clear();
+
+                THEN("Nothing should be found")
+                {
+                    REQUIRE(!cache.get(firstKey));
+                    REQUIRE(cache.usedBytes() == 0);
+                }
+            }
+
+            WHEN("The cache is shrunk to fit only one thumbnail")
+            {
+                cache.shrink(thumbnailSize);
+
+                THEN("Only the most recently used thumbnail should remain")
+                {
+                    REQUIRE(cache.contains(secondKey));
+                    REQUIRE(!cache.contains(firstKey));
+                    REQUIRE(cache.usedBytes() == thumbnailSize);
+                }
+            }
+        }
+
+        WHEN("A thumbnail bigger than the whole budget is inserted")
+        {
+            cache.insert(firstKey, createThumbnail(300));
+
+            THEN("It shouldn't be cached")
+            REQUIRE(!cache.get(firstKey));
+        }
+    }
+}
+
+SCENARIO("Persisting thumbnails on disk within a size budget")
+{
+    GIVEN("An empty disk cache in a fresh directory")
+    {
+        const std::string cacheDirectory = TempFile::generate()->get_path();
+        const std::string fileIdentity = "0123456789abcdef";
+        auto thumbnail = Gdk::Pixbuf::create(Gdk::COLORSPACE_RGB, true, 8, 100, 100);
+        thumbnail->fill(0xffffffff);
+
+        WHEN("A thumbnail is stored")
+        {
+            DiskThumbnailCache cache{cacheDirectory, 1024 * 1024};
+            cache.store(fileIdentity, "0-0-100", thumbnail);
+
+            THEN("It should be loaded back with the same dimensions")
+            {
+                auto loadedThumbnail = cache.load(fileIdentity, "0-0-100");
+
+                REQUIRE(loadedThumbnail);
+                REQUIRE(loadedThumbnail->get_width() == 100);
+                REQUIRE(loadedThumbnail->get_height() == 100);
+            }
+
+            THEN("It should be found by a new cache over the same directory")
+            {
+                DiskThumbnailCache newCache{cacheDirectory, 1024 * 1024};
+
+                REQUIRE(newCache.load(fileIdentity, "0-0-100"));
+                REQUIRE(newCache.usedBytes() == cache.usedBytes());
+            }
+
+            THEN("Other entries should miss")
+            REQUIRE(!cache.load(fileIdentity, "1-0-100"));
+        }
+
+        DiskThumbnailCache sizingCache{TempFile::generate()->get_path(), 1024 * 1024};
+        sizingCache.store(fileIdentity, "sizing", thumbnail);
+        const std::uint64_t entrySize = sizingCache.usedBytes();
+
+        WHEN("More thumbnails than the budget allows are stored")
+        {
+            DiskThumbnailCache cache{cacheDirectory, 2 * entrySize};
+            cache.store(fileIdentity, "0-0-100", thumbnail);
+            cache.store(fileIdentity, "1-0-100", thumbnail);
+            cache.load(fileIdentity, "0-0-100");
+            cache.store(fileIdentity, "2-0-100", thumbnail);
+
+            THEN("The least recently used one should be deleted")
+            {
+                REQUIRE(cache.load(fileIdentity, "0-0-100"));
+                REQUIRE(!cache.load(fileIdentity, "1-0-100"));
+                REQUIRE(cache.load(fileIdentity, "2-0-100"));
+                REQUIRE(cache.usedBytes() <= 2 * entrySize);
+            }
+        }
+
+        WHEN("The only thumbnail of a file is evicted by one of another file")
+        {
+            const std::string otherFileIdentity = "fedcba9876543210";
+
+            DiskThumbnailCache cache{cacheDirectory, entrySize};
+            cache.store(fileIdentity, "0-0-100", thumbnail);
+            cache.store(otherFileIdentity, "0-0-100", thumbnail);
+
+            THEN("The directory of the first file should be deleted")
+            {
+                REQUIRE(!cache.load(fileIdentity, "0-0-100"));
+                REQUIRE(!Glib::file_test(Glib::build_filename(cacheDirectory, fileIdentity),
+                                         Glib::FILE_TEST_EXISTS));
+                REQUIRE(cache.load(otherFileIdentity, "0-0-100"));
+            }
+        }
+    }
+}